@@ -7,7 +7,10 @@
 // =================================================================================== //
 
 
-void TrafficLight::init(int dataPin, int latchPin, int clkPin, int segP[], int digitsP[], int ledP[], 
+unsigned long BusStats::skippedWrites = 0;
+
+
+void TrafficLight::init(int dataPin, int latchPin, int clkPin, const int segP[], const int digitsP[], const int ledP[], 
                           int tR, int tG, int tY, int initState) {
   SPI_MOSI = dataPin;
   SPI_CS = latchPin;
@@ -40,7 +43,7 @@ void TrafficLight::init(int dataPin, int latchPin, int clkPin, int segP[], int d
 }
 
 
-void TrafficLight::init(int data, int latch, int clk, int segP[], int digitsP[], int hour_1, int hour_2) {
+void TrafficLight::init(int data, int latch, int clk, const int segP[], const int digitsP[], int hour_1, int hour_2) {
   SPI_MOSI = data;
   SPI_CS = latch;
   SPI_CLK = clk;
@@ -59,7 +62,7 @@ void TrafficLight::init(int data, int latch, int clk, int segP[], int digitsP[],
 }
 
 
-void TrafficLight::writeBitOrder(int* order, byte& firstPart, byte& secondPart) {
+void TrafficLight::writeBitOrder(byte* order, byte& firstPart, byte& secondPart) {
   for(int i=0; i<8; i++) {
     firstPart |= (order[15 - i] << i);
     secondPart |= (order[7-i] << i);
@@ -148,7 +151,7 @@ void TrafficLight::timeGreenDec() {
 
 
 BitOrder TrafficLight::generateBitOrder() {
-  int order[16]  = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+  byte order[16]  = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
   // if disTime > 100 (3 digits) only show 2 least significant digits
   int tmpTime = (disTime > 99) ? (disTime - 100) : disTime;
   int firstDigit = tmpTime / 10;
@@ -187,7 +190,7 @@ BitOrder TrafficLight::generateBitOrder() {
   // ######################################################################################################
   order[digitsPin[FIRST_DIGIT]] = 1;
   order[digitsPin[SECOND_DIGIT]] = 0;
-  byte tmp = BIT_MAP[firstDigit];
+  byte tmp = pgm_read_byte(&BIT_MAP[firstDigit]);
   for(int i=0; i<NUM_SEG; i++) {
     order[segPin[NUM_SEG - i - 1]] = 0; // clear
     order[segPin[NUM_SEG - i - 1]] = !!(tmp & (1 << i));
@@ -197,7 +200,7 @@ BitOrder TrafficLight::generateBitOrder() {
 
   order[digitsPin[FIRST_DIGIT]] = 0;
   order[digitsPin[SECOND_DIGIT]] = 1;
-  tmp = BIT_MAP[secondDigit];
+  tmp = pgm_read_byte(&BIT_MAP[secondDigit]);
   for(int i=0; i<NUM_SEG; i++) {
     order[segPin[NUM_SEG - i - 1]] = 0; // clear
     order[segPin[NUM_SEG - i - 1]] = !!(tmp & (1 << i));
@@ -229,7 +232,7 @@ void TrafficLight::show(BitOrder bitOrder, int idx) {
 
 void TrafficLight::controlYellow(int onOff) {
   BitOrder odr = {0, 0, 0, 0};
-  int b[16] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+  byte b[16] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
   
   if(onOff == ON) {
     b[ledPin[YELLOW]] = 0; // turn on YELLOW
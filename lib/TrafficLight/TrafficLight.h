@@ -27,9 +27,9 @@ struct BitOrder{
 
 
 // Bit map for digit 0 -> 9
-// 7-segment display
+// 7-segment display, kept in flash: read with pgm_read_byte()
 // ======================================== //
-const static byte BIT_MAP[10] = {
+const static byte BIT_MAP[10] PROGMEM = {
   B00000001, // 0
   B01001111, // 2 ...
   B00010010,
@@ -44,7 +44,17 @@ const static byte BIT_MAP[10] = {
 // ======================================== //
 
 
+// Writes skipped by TrafficLightT because the 74HC595 outputs would not change,
+// one counter shared by every light
+// ======================================== //
+struct BusStats {
+  static unsigned long skippedWrites;
+};
+// ======================================== //
+
+
 // class TrafficLight declare
+// pins given at run time; kept as library API, the firmware uses TrafficLightT
 // ======================================== //
 class TrafficLight {
     private:
@@ -59,7 +69,7 @@ class TrafficLight {
       int timeGreen;
       int timeYellow;
       int state;
-      void writeBitOrder(int* order, byte& firstPart, byte& secondPart);
+      void writeBitOrder(byte* order, byte& firstPart, byte& secondPart);
       
     public:
       TrafficLight() {};
@@ -68,8 +78,8 @@ class TrafficLight {
       // Initialize hardware config: SPI_MOSI, SPI_CS, SPI_CLK
       // Initialize which pin in Max7219 connect to the 7-segment, traffic light
       // -------------------------------------------------------------------------
-      void init(int dataPin, int latchPin, int clkPin, int segP[], int digitsP[], int ledP[], int tR, int tG, int tY, int initState);
-      void init(int dataPin, int latchPin, int clkPin, int segP[], int digitsP[], int hour_1, int hour_2);
+      void init(int dataPin, int latchPin, int clkPin, const int segP[], const int digitsP[], const int ledP[], int tR, int tG, int tY, int initState);
+      void init(int dataPin, int latchPin, int clkPin, const int segP[], const int digitsP[], int hour_1, int hour_2);
       // Getter, setter
       // -------------------------------------
       void setState(int s);
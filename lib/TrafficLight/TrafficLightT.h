@@ -0,0 +1,234 @@
+#ifndef _TRAFFIC_LIGHT_T_
+#define _TRAFFIC_LIGHT_T_
+
+#include "TrafficLight.h"
+
+// =================================================================================== //
+//                                TrafficLightT.h
+// Compile-time configured variant of TrafficLight.
+// Pins on the Arduino board and pins in the 2-IC 74HC595 chain are template
+// parameters, so they cost no SRAM; only timing, state and the last latched frame are stored
+// (11 bytes, TrafficLight keeps 20 int). Same interface as TrafficLight without the pins in init().
+//
+// Usage:
+//   typedef TrafficLightT< BoardConfig<5, 6, 7> > Light1;   // DS, STCP, SHCP
+//   Light1 t1;
+//   t1.init(68, 46, 3, RED);
+// =================================================================================== //
+
+
+// SRAM budget of one light (bytes), checked with static_assert
+// -------------------------------------------------------------
+#ifndef TL_RAM_BUDGET_PER_LIGHT
+#define TL_RAM_BUDGET_PER_LIGHT     12
+#endif
+
+
+// Pins in 2-IC 74HC595 (0-15), wiring of the lights in main.cpp
+// seg: pins use to control 2-digit 7-segment
+// digit: pins use to control digits(2 digits)
+// led: pins use to control Light{RED, GREEN, YELLOW}
+// ======================================== //
+struct StandardPinMap {
+  static constexpr uint8_t seg(uint8_t i)   { return i; }
+  static constexpr uint8_t digit(uint8_t i) { return 8 + i; }
+  static constexpr uint8_t led(uint8_t i)   { return 13 + i; }
+};
+// ======================================== //
+
+
+// Board config: Arduino pins connect to DS, STCP, SHCP of the 74HC595 chain
+// ======================================== //
+template <uint8_t DS, uint8_t STCP, uint8_t SHCP, class PinMap = StandardPinMap>
+struct BoardConfig {
+  static const uint8_t DATA_PIN  = DS;
+  static const uint8_t LATCH_PIN = STCP;
+  static const uint8_t CLK_PIN   = SHCP;
+  typedef PinMap Pins;
+};
+// ======================================== //
+
+
+// Frame: 16 bit shifted to the 74HC595 chain, bit n <-> pin n
+// first: frame shows the first digit, second: frame shows the second digit
+// ======================================== //
+struct Frame {
+  uint16_t first;
+  uint16_t second;
+};
+// ======================================== //
+
+
+// Helpers for the compile-time pin masks
+// ======================================== //
+constexpr uint16_t tlBit(uint8_t pin) { return (uint16_t)1 << pin; }
+constexpr uint8_t tlPopCount(uint16_t v) { return v ? (v & 1) + tlPopCount(v >> 1) : 0; }
+// ======================================== //
+
+
+// class TrafficLightT declare
+// ======================================== //
+template <class Board>
+class TrafficLightT {
+    private:
+      typedef typename Board::Pins Pins;
+
+      static constexpr uint16_t SEG_MASK = tlBit(Pins::seg(0)) | tlBit(Pins::seg(1)) | tlBit(Pins::seg(2)) | tlBit(Pins::seg(3))
+                                         | tlBit(Pins::seg(4)) | tlBit(Pins::seg(5)) | tlBit(Pins::seg(6));
+      static constexpr uint16_t DIGIT_MASK = tlBit(Pins::digit(FIRST_DIGIT)) | tlBit(Pins::digit(SECOND_DIGIT));
+      static constexpr uint16_t LED_MASK = tlBit(Pins::led(RED)) | tlBit(Pins::led(GREEN)) | tlBit(Pins::led(YELLOW));
+
+      static_assert(Board::DATA_PIN < NUM_DIGITAL_PINS && Board::LATCH_PIN < NUM_DIGITAL_PINS
+                    && Board::CLK_PIN < NUM_DIGITAL_PINS, "TrafficLightT: board pin out of range");
+      static_assert(Pins::seg(0) < 16 && Pins::seg(1) < 16 && Pins::seg(2) < 16 && Pins::seg(3) < 16
+                    && Pins::seg(4) < 16 && Pins::seg(5) < 16 && Pins::seg(6) < 16
+                    && Pins::digit(FIRST_DIGIT) < 16 && Pins::digit(SECOND_DIGIT) < 16
+                    && Pins::led(RED) < 16 && Pins::led(GREEN) < 16 && Pins::led(YELLOW) < 16,
+                    "TrafficLightT: 74HC595 pin out of range (0-15)");
+      static_assert(tlPopCount(SEG_MASK | DIGIT_MASK | LED_MASK) == NUM_SEG + NUM_DIGIT + NUM_LED,
+                    "TrafficLightT: two outputs share a 74HC595 pin");
+
+      // Frame never produced by generateBitOrder()/controlYellow(): all unused 74HC595 pins set
+      static constexpr uint16_t NO_FRAME = (uint16_t)~(SEG_MASK | DIGIT_MASK | LED_MASK);
+
+      int16_t disTime;
+      uint16_t latched;   // last frame latched to the chain, NO_FRAME if unknown
+      int16_t timeRed;      // signed like TrafficLight: setup code wraps on < 0
+      int16_t timeGreen;
+      int16_t timeYellow;
+      uint8_t state;
+
+      // lamp bits for a state: active LOW, other lamps off
+      static uint16_t lampBits(uint8_t s) { return LED_MASK & ~tlBit(Pins::led(s)); }
+
+      // segment bits for a digit 0 -> 9
+      static uint16_t segBits(uint8_t d) {
+        byte tmp = pgm_read_byte(&BIT_MAP[d]);
+        uint16_t bits = 0;
+        for(uint8_t i=0; i<NUM_SEG; i++) {
+          if(tmp & (1 << i)) bits |= tlBit(Pins::seg(NUM_SEG - i - 1));
+        }
+        return bits;
+      }
+
+      // shiftOut a frame and latch it, high byte ends in the second IC
+      // skip the write if the outputs would not change
+      void write(uint16_t frame) {
+        if(frame == latched) {
+          BusStats::skippedWrites++;
+          return;
+        }
+
+        digitalWrite(Board::LATCH_PIN, LOW);
+        shiftOut(Board::DATA_PIN, Board::CLK_PIN, MSBFIRST, frame >> 8);
+        shiftOut(Board::DATA_PIN, Board::CLK_PIN, MSBFIRST, frame & 0xFF);
+        digitalWrite(Board::LATCH_PIN, HIGH);
+        latched = frame;
+      }
+
+    public:
+      TrafficLightT() : latched(NO_FRAME) {
+        static_assert(sizeof(TrafficLightT) <= TL_RAM_BUDGET_PER_LIGHT, "TrafficLightT: over SRAM budget per light");
+      };
+      ~TrafficLightT() {};
+
+      // Initialize timing and first state, pins are given by Board
+      // -------------------------------------------------------------------------
+      void init(int16_t tR, int16_t tG, int16_t tY, uint8_t initState) {
+        timeRed = tR;
+        timeGreen = tG;
+        timeYellow = tY;
+        state = initState;
+        disTime = (state == RED) ? timeRed : (state == GREEN) ? timeGreen : timeYellow;
+      }
+      void init(int16_t hour_1, int16_t hour_2) {
+        timeRed = hour_1;
+        timeGreen = hour_2;
+        timeYellow = 0;
+        state = RED;
+        disTime = timeRed;
+      }
+
+      // Getter, setter
+      // -------------------------------------
+      void setState(uint8_t s) { state = s; }
+      void setDisTime(int16_t t) { disTime = t; }
+      void setTimeRed(int16_t tR) { timeRed = tR; }
+      void setTimeGreen(int16_t tG) { timeGreen = tG; }
+      void setTimeYellow(int16_t tY) { timeYellow = tY; }
+      int16_t getTimeRed() const { return timeRed; }
+      int16_t getTimeGreen() const { return timeGreen; }
+      int16_t getTimeYellow() const { return timeYellow; }
+      uint8_t getState() const { return state; }
+      int16_t getDisTime() const { return disTime; }
+
+      // Changes values of disTime, timeRed, timeGreen
+      // ---------------------------------------------
+      void timeDecreaseOne() { disTime--; }
+      void timeRedInc() { timeRed++; }
+      void timeRedDec() { timeRed--; }
+      void timeGreenInc() { timeGreen++; }
+      void timeGreenDec() { timeGreen--; }
+
+      // Turn off or turn on YELLOW light, turn of RED, GREEN light
+      // -----------------------------------------------------------
+      void controlYellow(int onOff) {
+        write(onOff == ON ? lampBits(YELLOW) : LED_MASK);
+      }
+
+      // Generate frames corresponding to the status to be displayed,
+      // same output as TrafficLight::generateBitOrder()
+      // -------------------------------------
+      Frame generateBitOrder() const {
+        Frame result;
+        uint16_t lamps = lampBits(state);
+
+        if(state == YELLOW) { // if state is YELLOW => don't show digits
+          result.first = result.second = lamps;
+          return result;
+        }
+
+        // if disTime > 100 (3 digits) only show 2 least significant digits
+        int16_t tmpTime = (disTime > 99) ? (disTime - 100) : disTime;
+        result.first = lamps | tlBit(Pins::digit(FIRST_DIGIT)) | segBits(tmpTime / 10);
+        result.second = lamps | tlBit(Pins::digit(SECOND_DIGIT)) | segBits(tmpTime % 10);
+        return result;
+      }
+
+      // shiftOut the frame to show the current state {RED, GREEN, YELLOW}, time
+      // param: frame(Frame) - the frames corresponding to the status display
+      //        idx(int) - the index of digit, only show a digit/times -> flash 7-segment
+      // --------------------------------------------------------------------------------
+      void show(const Frame& frame, int idx) {
+        write(idx == FIRST_DIGIT ? frame.first : frame.second);
+      }
+
+      // turn off the light
+      // --------------------------------------------------------------------------------
+      void turnOff() { controlYellow(OFF); }
+
+      // check disTime < 0 ? (Change state)
+      // --------------------------------------------------------------------------------
+      bool isChangeState() const { return disTime < 0; }
+
+      // change the current state and display time
+      // RED --> GREEN
+      // GREEN --> YELLOW
+      // YELLOW --> RED
+      // ---------------------------------------------------------------------------------
+      void changeState() {
+        if(state == RED) {
+          state = GREEN;
+          disTime = timeGreen;
+        } else if(state == GREEN) {
+          state = YELLOW;
+          disTime = timeYellow;
+        } else {
+          state = RED;
+          disTime = timeRed;
+        }
+      }
+};
+// ======================================== //
+
+#endif // _TRAFFIC_LIGHT_T_
@@ -0,0 +1,257 @@
+#include  "TrafficStats.h"
+#include  <EEPROM.h>
+
+// =================================================================================== //
+//                                TrafficStats.cpp
+// Definite class TrafficStats
+//
+// EEPROM layout from STATS_EEPROM_BASE:
+//   [0] STATS_MAGIC  [1] bin minutes  (written only when the ring is created)
+//   [2 ...] STATS_EEPROM_BINS slots of StatsBin, a ring
+// No head in EEPROM: each slot is written once per turn of the ring, init() finds
+// the newest bin by its serial. A slot is empty while its serial high byte is 0xFF,
+// this byte is cleared first and written last, so a bin cut by a reset is not read.
+// =================================================================================== //
+// =================================================================================== //
+
+#define   STATS_HEADER_SIZE     2
+#define   ADDR_MAGIC            (STATS_EEPROM_BASE + 0)
+#define   ADDR_MINUTES          (STATS_EEPROM_BASE + 1)
+#define   SERIAL_HI             1       // offset of the serial high byte in a slot (little endian)
+#define   SLOT_EMPTY            0xFF
+#define   FLUSH_STEPS           (sizeof(StatsBin) + 1)
+#define   NO_FLUSH              0xFF
+
+
+void TrafficStats::init(uint8_t minutes, const DateTime& now) {
+  binMinutes = (minutes == BIN_5_MIN) ? BIN_5_MIN : BIN_15_MIN;
+  serial = now.secondstime() / (binMinutes * 60UL);
+  binStartMs = millis();
+  flushPos = NO_FLUSH;
+  memset(&pending, 0, sizeof(pending));
+
+  for(int i=0; i<NUM_APPROACH; i++) {
+    count[i] = 0;
+    redArrivals[i] = 0;
+    occupiedMs[i] = 0;
+    onSince[i] = 0;
+    occupied[i] = false;
+    signal[i] = GREEN;
+  }
+
+  if(EEPROM.read(ADDR_MAGIC) != STATS_MAGIC || EEPROM.read(ADDR_MINUTES) != binMinutes) {
+    // new board or other bin size: start an empty ring
+    EEPROM.update(ADDR_MAGIC, STATS_MAGIC);
+    EEPROM.update(ADDR_MINUTES, binMinutes);
+    resetRing();
+    return;
+  }
+
+  // newest bin: the smallest age, the next slot is the head
+  head = 0;
+  uint16_t newestAge = 0xFFFF;
+  for(uint8_t slot=0; slot<STATS_EEPROM_BINS; slot++) {
+    uint16_t stored;
+    EEPROM.get(slotAddress(slot), stored);
+    if(stored >= STATS_SERIAL_MOD) continue;
+
+    uint16_t age = binAge(stored);
+    if(age == 0 || age > STATS_SERIAL_MOD / 2) {
+      // RTC at or before a stored bin (set back or lost): the ring can't be ordered
+      resetRing();
+      return;
+    }
+    if(age < newestAge) {
+      newestAge = age;
+      head = (slot + 1) % STATS_EEPROM_BINS;
+    }
+  }
+}
+
+
+// Bins from a stored serial to the bin being counted
+uint16_t TrafficStats::binAge(uint16_t storedSerial) {
+  return ((serial % STATS_SERIAL_MOD) + STATS_SERIAL_MOD - storedSerial) % STATS_SERIAL_MOD;
+}
+
+
+// Mark every slot empty, one byte per slot
+void TrafficStats::resetRing() {
+  for(uint8_t slot=0; slot<STATS_EEPROM_BINS; slot++) {
+    EEPROM.update(slotAddress(slot) + SERIAL_HI, SLOT_EMPTY);
+  }
+  head = 0;
+}
+
+
+void TrafficStats::detectorChange(uint8_t approach, bool isOccupied) {
+  uint8_t oldSREG = SREG;
+  cli();
+
+  if(isOccupied != occupied[approach]) {
+    uint32_t nowMs = millis();
+    if(isOccupied) {
+      onSince[approach] = nowMs;
+      if(count[approach] < 0xFFFF) count[approach]++;
+      if(signal[approach] == RED && redArrivals[approach] < 0xFF) redArrivals[approach]++;
+    } else {
+      occupiedMs[approach] += nowMs - onSince[approach];
+    }
+    occupied[approach] = isOccupied;
+  }
+
+  SREG = oldSREG;
+}
+
+
+void TrafficStats::setSignal(uint8_t approach, uint8_t state) {
+  signal[approach] = state;
+}
+
+
+// Move the bin being counted to pending and restart it, interrupts must be off
+void TrafficStats::closeBin(uint32_t nowMs) {
+  uint32_t binMs = nowMs - binStartMs;
+  uint32_t scale = 0;   // binMs, occ >> scale keep occ * OCCUPANCY_FULL in 32 bits (late update())
+  while((binMs >> scale) > 0xFFFFFFFFUL / OCCUPANCY_FULL) scale++;
+
+  pending.serial = serial % STATS_SERIAL_MOD;
+  for(int i=0; i<NUM_APPROACH; i++) {
+    uint32_t occ = occupiedMs[i];
+    if(occupied[i]) { // vehicle over the detector: split its time between the 2 bins
+      occ += nowMs - onSince[i];
+      onSince[i] = nowMs;
+    }
+
+    pending.count[i] = count[i];
+    pending.redArrivals[i] = redArrivals[i];
+    pending.occupancy[i] = (binMs == 0 || occ >= binMs) ? (binMs ? OCCUPANCY_FULL : 0)
+                                                          : (uint8_t)((occ >> scale) * OCCUPANCY_FULL / (binMs >> scale));
+
+    count[i] = 0;
+    redArrivals[i] = 0;
+    occupiedMs[i] = 0;
+  }
+
+  binStartMs = nowMs;
+}
+
+
+bool TrafficStats::update(const DateTime& now) {
+  uint32_t s = now.secondstime() / (binMinutes * 60UL);
+  if(s == serial) return false;
+
+  // previous bin not stored yet (service() not called): finish it
+  while(flushPos != NO_FLUSH) flushByte();
+
+  uint8_t oldSREG = SREG;
+  cli();
+  closeBin(millis());
+  SREG = oldSREG;
+
+  if(s < serial) {
+    // RTC set back: stored bins would be after the new ones
+    resetRing();
+    serial = s;
+    return false;
+  }
+
+  serial = s;
+  flushPos = 0;
+  return true;
+}
+
+
+int TrafficStats::slotAddress(uint8_t slot) {
+  return STATS_EEPROM_BASE + STATS_HEADER_SIZE + slot * (int)sizeof(StatsBin);
+}
+
+
+// Write one byte of pending to the head slot:
+// serial high byte = SLOT_EMPTY, the counters, serial low byte, serial high byte
+void TrafficStats::flushByte() {
+  int addr = slotAddress(head);
+  const uint8_t* bytes = (const uint8_t*)&pending;
+
+  if(flushPos == 0) {
+    EEPROM.update(addr + SERIAL_HI, SLOT_EMPTY);
+  } else if(flushPos < sizeof(StatsBin) - 1) {
+    EEPROM.update(addr + flushPos + 1, bytes[flushPos + 1]);
+  } else {
+    uint8_t i = flushPos - (sizeof(StatsBin) - 1);   // 0: serial low byte, 1: high byte
+    EEPROM.update(addr + i, bytes[i]);
+  }
+
+  flushPos++;
+  if(flushPos == FLUSH_STEPS) {
+    head = (head + 1) % STATS_EEPROM_BINS;
+    flushPos = NO_FLUSH;
+  }
+}
+
+
+void TrafficStats::service() {
+  if(flushPos != NO_FLUSH) flushByte();
+}
+
+
+const StatsBin& TrafficStats::getLastBin() {
+  return pending;
+}
+
+
+static void print2(Print& out, int v) {
+  if(v < 10) out.print('0');
+  out.print(v);
+}
+
+
+void TrafficStats::printBin(Print& out, const StatsBin& bin, uint32_t fullSerial) {
+  DateTime start(SECONDS_FROM_1970_TO_2000 + fullSerial * binMinutes * 60UL);
+
+  for(int i=0; i<NUM_APPROACH; i++) {
+    out.print(start.year());
+    out.print('-');
+    print2(out, start.month());
+    out.print('-');
+    print2(out, start.day());
+    out.print(' ');
+    print2(out, start.hour());
+    out.print(':');
+    print2(out, start.minute());
+    out.print(',');
+    out.print(i + 1);
+    out.print(',');
+    out.print(bin.count[i]);
+    out.print(',');
+    out.print(bin.occupancy[i] / 2);
+    out.print((bin.occupancy[i] & 1) ? ".5" : ".0");
+    out.print(',');
+    out.println(bin.redArrivals[i]);
+  }
+}
+
+
+void TrafficStats::exportBins(Print& out) {
+  while(flushPos != NO_FLUSH) flushByte();
+
+  out.println(F("start,approach,count,occupancy_pct,red_arrivals"));
+  // from the head: oldest slot first, empty slots skipped
+  for(int i=0; i<STATS_EEPROM_BINS; i++) {
+    uint8_t slot = (head + i) % STATS_EEPROM_BINS;
+    StatsBin bin;
+    EEPROM.get(slotAddress(slot), bin);
+    if(bin.serial >= STATS_SERIAL_MOD) continue;
+    printBin(out, bin, serial - binAge(bin.serial));
+  }
+}
+
+
+void TrafficStats::exportLastBin(Print& out) {
+  printBin(out, pending, serial - binAge(pending.serial));
+}
+
+
+// =================================================================================== //
+// =================================================================================== //
+// =================================================================================== //
@@ -0,0 +1,107 @@
+#ifndef _TRAFFIC_STATS_
+#define _TRAFFIC_STATS_
+
+#include <Arduino.h>
+#include <RTClib.h>
+#include <TrafficLight.h>
+
+#define   NUM_APPROACH          2
+#define   BIN_5_MIN             5
+#define   BIN_15_MIN            15
+#define   STATS_EEPROM_BASE     0
+#define   STATS_EEPROM_BINS     96      // 15 min bins: last day, 5 min bins: last 8 hours
+#define   STATS_MAGIC           0x5B
+#define   STATS_SERIAL_MOD      0xFF00  // stored serials: high byte 0xFF is an empty slot
+#define   OCCUPANCY_FULL        200     // occupancy unit: 0.5%
+
+
+// Struct StatsBin: statistics of one time bin, packed as stored in EEPROM (10 bytes)
+// serial: bin number since 2000-01-01 00:00 (mod STATS_SERIAL_MOD), bins are aligned to the RTC
+// count: vehicles, occupancy: time detector occupied (0.5%), redArrivals: vehicles arrived on RED
+// counters saturate instead of wrapping
+// ======================================== //
+struct StatsBin {
+  uint16_t serial;
+  uint16_t count[NUM_APPROACH];
+  uint8_t occupancy[NUM_APPROACH];
+  uint8_t redArrivals[NUM_APPROACH];
+} __attribute__((packed));
+// ======================================== //
+
+
+// class TrafficStats declare
+// ======================================== //
+class TrafficStats {
+    private:
+      // Bin being counted, written from the detector interrupt
+      volatile uint16_t count[NUM_APPROACH];
+      volatile uint8_t redArrivals[NUM_APPROACH];
+      volatile uint32_t occupiedMs[NUM_APPROACH];
+      volatile uint32_t onSince[NUM_APPROACH];   // millis() when the detector became occupied
+      volatile bool occupied[NUM_APPROACH];
+      volatile uint8_t signal[NUM_APPROACH];     // light state of the approach {RED, GREEN, YELLOW}
+
+      uint8_t binMinutes;
+      uint32_t serial;      // serial of the bin being counted
+      uint32_t binStartMs;  // millis() when the bin being counted started
+
+      // Closed bin waiting to be written to EEPROM, one byte per service()
+      StatsBin pending;
+      uint8_t flushPos;     // next byte of pending to write, 0xFF: nothing to write
+      uint8_t head;         // next EEPROM slot
+
+      int slotAddress(uint8_t slot);
+      uint16_t binAge(uint16_t storedSerial);
+      void resetRing();
+      void flushByte();
+      void closeBin(uint32_t nowMs);
+      void printBin(Print& out, const StatsBin& bin, uint32_t fullSerial);
+
+    public:
+      TrafficStats() {};
+      ~TrafficStats() {};
+
+      // Initialize bin size {BIN_5_MIN, BIN_15_MIN} and start the first bin
+      // the EEPROM ring is kept if it was written with the same bin size
+      // and the RTC is after every stored bin, else it is cleared
+      // -------------------------------------------------------------------------
+      void init(uint8_t minutes, const DateTime& now);
+
+      // Detector input of an approach changed, occupied: vehicle over the detector
+      // count a vehicle on the rising edge, O(1), safe from interrupt context
+      // calling it without a change does nothing
+      // -------------------------------------------------------------------------
+      void detectorChange(uint8_t approach, bool isOccupied);
+
+      // Light state of an approach {RED, GREEN, YELLOW}, used for red-light arrivals
+      // -------------------------------------------------------------------------
+      void setSignal(uint8_t approach, uint8_t state);
+
+      // Close the bin when the RTC enters a new one, call at least once per second
+      // return true if a bin was closed (getLastBin() gives it)
+      // a late call closes the old bin with everything counted since, bins in between are missing
+      // RTC set back: the bin being counted and the EEPROM ring are dropped
+      // -------------------------------------------------------------------------
+      bool update(const DateTime& now);
+
+      // Write at most one byte of the last closed bin to EEPROM
+      // call from the refresh loop: never blocks the display for more than one byte
+      // -------------------------------------------------------------------------
+      void service();
+
+      // Last closed bin
+      // -------------------------------------------------------------------------
+      const StatsBin& getLastBin();
+
+      // Print the bins stored in EEPROM, oldest first, as CSV:
+      // start,approach,count,occupancy_pct,red_arrivals
+      // -------------------------------------------------------------------------
+      void exportBins(Print& out);
+
+      // Print the last closed bin as CSV (same columns as exportBins)
+      // -------------------------------------------------------------------------
+      void exportLastBin(Print& out);
+};
+// ======================================== //
+
+#endif // _TRAFFIC_STATS_
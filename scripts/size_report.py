@@ -0,0 +1,59 @@
+# =================================================================================== #
+#                                size_report.py
+# PlatformIO post script: after linking, print SRAM / flash used by every symbol of
+# firmware.elf (from avr-nm), so the cost of each light (t1, t2, timeBox), of stats
+# and of tables like BIT_MAP is visible.
+#
+# The linked elf is used, not the object files: the Uno build uses -flto, so the
+# objects hold only LTO bytecode and avr-size reports 0 for them.
+#
+#   SRAM  = .data + .bss symbols  (stack and heap not included)
+#   flash = .text symbols (code, PROGMEM tables) + .data initial values
+# =================================================================================== #
+import os
+import subprocess
+
+Import("env")
+
+# avr-nm symbol types
+RAM_TYPES = "dDbB"
+FLASH_TYPES = "tTrRwW"
+NUM_FLASH_ROWS = 25
+
+
+def read_symbols(nm_tool, elf):
+    # avr-nm -S -C --size-sort: address size type name (name may contain spaces)
+    out = subprocess.check_output([nm_tool, "--size-sort", "-S", "-C", elf]).decode()
+    symbols = []
+    for line in out.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) == 4:
+            symbols.append((fields[3], int(fields[1], 16), fields[2]))
+    return symbols
+
+
+def print_rows(title, rows):
+    print("%-60s %8s" % (title, "Bytes"))
+    print("-" * 69)
+    for name, size in rows:
+        print("%-60s %8d" % (name[:60], size))
+    print("-" * 69)
+    print("%-60s %8d" % ("Total (listed)", sum(r[1] for r in rows)))
+    print("")
+
+
+def size_report(source, target, env):
+    elf = target[0].get_abspath()
+    size_tool = env.subst("$SIZETOOL")
+    nm_tool = os.path.join(os.path.dirname(size_tool), os.path.basename(size_tool).replace("size", "nm"))
+    symbols = read_symbols(nm_tool, elf)
+
+    ram = sorted([(n, s) for n, s, t in symbols if t in RAM_TYPES], key=lambda r: r[1], reverse=True)
+    flash = sorted([(n, s) for n, s, t in symbols if t in FLASH_TYPES], key=lambda r: r[1], reverse=True)
+
+    print("")
+    print_rows("SRAM symbol", ram)
+    print_rows("Flash symbol (largest %d)" % NUM_FLASH_ROWS, flash[:NUM_FLASH_ROWS])
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", size_report)
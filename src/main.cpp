@@ -1,5 +1,6 @@
 #include <Arduino.h>
-#include <TrafficLight.h>
+#include <TrafficLightT.h>
+#include <TrafficStats.h>
 #include <Wire.h>
 #include <RTClib.h>
 
@@ -21,6 +22,11 @@
 #define    TIME_DEBOUNCE_US     20
 #define    START                0
 #define    END                  1
+#define    STATS_BIN_MIN        BIN_15_MIN
+
+// Export traffic statistics over Serial: build with -D STATS_SERIAL
+// (with each closed bin: "# skipped writes N", 74HC595 writes skipped since boot)
+// Serial uses pins 0, 1 => BUTTON_UP, BUTTON_DOWN can't be used in this build
 
 
 // -------------------------------------------------------------------------------------
@@ -38,51 +44,52 @@ static volatile int flagMode;
 static volatile int flagLightChange;
 static volatile int startEnd; // choose which will be setup <START, END> in SET_TIME_AUTO mode
 
-int START_HOUR = 6;
-int END_HOUR   = 22;
-typedef TrafficLight TimeBox;
+const int START_HOUR = 6;
+const int END_HOUR   = 22;
 
 
 
 // -------------------------------------------------------------------------------------
 // Pin on Arduino Board
 // Use to config TrafficLight
+// const: folded into code, no SRAM used
 // -------------------------------------------------------------------------------------
-int DS_PIN_L1     =   5;
-int STCP_PIN_L1   =   6;
-int SHCP_PIN_L1   =   7;
-int DS_PIN_L2     =   8;
-int STCP_PIN_L2   =   9;
-int SHCP_PIN_L2   =   10;
-int DS_PIN_TB     =   11;
-int STCP_PIN_TB   =   12;
-int SHCP_PIN_TB   =   13;
-int BUTTON_UP     =   1;
-int BUTTON_DOWN   =   0;
+const int DS_PIN_L1     =   5;
+const int STCP_PIN_L1   =   6;
+const int SHCP_PIN_L1   =   7;
+const int DS_PIN_L2     =   8;
+const int STCP_PIN_L2   =   9;
+const int SHCP_PIN_L2   =   10;
+const int DS_PIN_TB     =   11;
+const int STCP_PIN_TB   =   12;
+const int SHCP_PIN_TB   =   13;
+const int BUTTON_UP     =   1;
+const int BUTTON_DOWN   =   0;
+const int DETECTOR_L1   =   A0;   // vehicle detectors, LOW: occupied
+const int DETECTOR_L2   =   A1;   // A0, A1 => pin change interrupt PCINT1
 
 // -------------------------------------------------------------------------------------
 // config parameters for TrafficLight
 // -------------------------------------------------------------------------------------
-int TIME_RED_L1     =   68;
-int TIME_GREEN_L1   =   46;
-int TIME_YELLOW_L1  =   3;
-int INIT_STATE_L1   =   RED;
+const int TIME_RED_L1     =   68;
+const int TIME_GREEN_L1   =   46;
+const int TIME_YELLOW_L1  =   3;
+const int INIT_STATE_L1   =   RED;
 
-int TIME_RED_L2     =   28;
-int TIME_GREEN_L2   =   20;
-int TIME_YELLOW_L2  =   5;
-int INIT_STATE_L2   =   GREEN;
+const int TIME_RED_L2     =   28;
+const int TIME_GREEN_L2   =   20;
+const int TIME_YELLOW_L2  =   5;
+const int INIT_STATE_L2   =   GREEN;
 
 
 // -------------------------------------------------------------------------------------
-// Pins in 2-IC 74HC595 use to config TrafficLight (0-15)
-// sP: pins use to control 2-digit 7-segment
-// dP: pins use to control digits(2 digits)
-// lP: pins use to control Light{RED, GREEN, BLUE}
+// Lights: pins are template parameters (no SRAM), checked at compile time
+// Pins in 2-IC 74HC595 (0-15): StandardPinMap
+//   segments {0, 1, 2, 3, 4, 5, 6}, digits {8, 9}, Light{RED, GREEN, YELLOW} {13, 14, 15}
 // -------------------------------------------------------------------------------------
-int sP[] = {0, 1, 2, 3, 4, 5, 6};
-int dP[] = {8, 9};
-int lP[] = {13, 14, 15};
+typedef TrafficLightT< BoardConfig<DS_PIN_L1, STCP_PIN_L1, SHCP_PIN_L1> > Light1;
+typedef TrafficLightT< BoardConfig<DS_PIN_L2, STCP_PIN_L2, SHCP_PIN_L2> > Light2;
+typedef TrafficLightT< BoardConfig<DS_PIN_TB, STCP_PIN_TB, SHCP_PIN_TB> > TimeBox;
 
 
 // -------------------------------------------------------------------------------------
@@ -92,14 +99,15 @@ void changeMode();          //  Interrupt functions
 void changeLightNumber();   //  Interrupt functions
 
 // start standard mode: RED -> GREEN -> YELLOW, counting from TIME_RED, TIME_GREEN to 0
-void startStandardMode(TrafficLight& tf1, TrafficLight& tf2);
+template <class L1, class L2> void startStandardMode(L1& tf1, L2& tf2);
 
 // start yellow light blink mode: yellow light will blink until change state
-void startBlinkYellowMode(TrafficLight tf1, TrafficLight tf2);
+// lights are passed by reference: each one keeps the last frame latched to its 74HC595
+template <class L1, class L2> void startBlinkYellowMode(L1& tf1, L2& tf2);
 
 // setup time for TrafficLight, 
 // "state" parameter use for specify what time to setup {RED, GREEN}
-void setupTime(TrafficLight& tf, int state);
+template <class Light> void setupTime(Light& tf, int state);
 
 // Auto Mode:
 //     ex. start = 6h
@@ -110,11 +118,17 @@ void setupTime(TrafficLight& tf, int state);
 // param TimeBox tb saved timeRed as time start, timeGreen as time end
 void startSetTimeAutoMode(TimeBox& tb);
 
+// close the statistics bin when the RTC enters a new one (print it in STATS_SERIAL builds)
+// call at least once per second, also from loops that don't return to loop()
+void updateStats(const DateTime& now);
+
 
 // Declare two TrafficLight
-TrafficLight t1, t2;
+Light1 t1;
+Light2 t2;
 RTC_DS1307 rtc;
 TimeBox timeBox;
+TrafficStats stats;
 
 
 // ================================================================================================================
@@ -136,15 +150,31 @@ void setup() {
   pinMode(BUTTON_UP, INPUT);
   pinMode(BUTTON_DOWN, INPUT);
 
-  t1.init(DS_PIN_L1, STCP_PIN_L1, SHCP_PIN_L1, sP, dP, lP, TIME_RED_L1, TIME_GREEN_L1, TIME_YELLOW_L1, INIT_STATE_L1);
-  t2.init(DS_PIN_L2, STCP_PIN_L2, SHCP_PIN_L2, sP, dP, lP, TIME_RED_L2, TIME_GREEN_L2, TIME_YELLOW_L2, INIT_STATE_L2);
-  timeBox.init(DS_PIN_TB, STCP_PIN_TB, SHCP_PIN_TB, sP, dP, START_HOUR, END_HOUR);
+  // Detectors as Input
+  pinMode(DETECTOR_L1, INPUT_PULLUP);
+  pinMode(DETECTOR_L2, INPUT_PULLUP);
+
+  t1.init(TIME_RED_L1, TIME_GREEN_L1, TIME_YELLOW_L1, INIT_STATE_L1);
+  t2.init(TIME_RED_L2, TIME_GREEN_L2, TIME_YELLOW_L2, INIT_STATE_L2);
+  timeBox.init(START_HOUR, END_HOUR);
 
   attachInterrupt(digitalPinToInterrupt(2), changeMode, FALLING);
   attachInterrupt(digitalPinToInterrupt(3), changeLightNumber, FALLING);
 
   rtc.begin();
-  rtc.adjust(DateTime(__DATE__, __TIME__));
+  // set the build time only on a stopped RTC: adjusting on every boot moves it back
+  if(!rtc.isrunning()) {
+    rtc.adjust(DateTime(__DATE__, __TIME__));
+  }
+
+  stats.init(STATS_BIN_MIN, rtc.now());
+  PCMSK1 |= _BV(PCINT8) | _BV(PCINT9); // A0, A1
+  PCICR |= _BV(PCIE1);
+
+#ifdef STATS_SERIAL
+  Serial.begin(9600);
+  stats.exportBins(Serial);
+#endif
 }
 // ================================================================================================================
 // ================================================================================================================
@@ -158,6 +188,8 @@ void loop() {
   flagMode = 0; // reset flagMode
   flagLightChange = 0; // reset flagLightChange
   DateTime now = rtc.now();
+  updateStats(now);
+  stats.service();
 
   switch (mode) {
     case STANDARD_MODE:
@@ -174,11 +206,15 @@ void loop() {
       else startStandardMode(t1, t2);
       break;
     case SET_TIME_AUTO:
+      stats.setSignal(LIGHT_1, YELLOW); // lights off: no red-light arrivals
+      stats.setSignal(LIGHT_2, YELLOW);
       t1.turnOff();
       t2.turnOff();
       startSetTimeAutoMode(timeBox);
       break;
     case SETUP_RED:
+      stats.setSignal(LIGHT_1, YELLOW);
+      stats.setSignal(LIGHT_2, YELLOW);
       timeBox.turnOff();
       if(lightNumber == LIGHT_1) {
         t2.turnOff();
@@ -190,6 +226,8 @@ void loop() {
       break;
 
     case SETUP_GREEN:
+      stats.setSignal(LIGHT_1, YELLOW);
+      stats.setSignal(LIGHT_2, YELLOW);
       timeBox.turnOff();
       if(lightNumber == LIGHT_1) {
         t2.turnOff();
@@ -235,9 +273,30 @@ void changeLightNumber() {
 }
 
 
-void startStandardMode(TrafficLight& tf1, TrafficLight& tf2) {
-  BitOrder bodr1 = tf1.generateBitOrder();
-  BitOrder bodr2 = tf2.generateBitOrder();
+void updateStats(const DateTime& now) {
+  if(stats.update(now)) {
+#ifdef STATS_SERIAL
+    stats.exportLastBin(Serial);
+    Serial.print(F("# skipped writes "));
+    Serial.println(BusStats::skippedWrites);
+#endif
+  }
+}
+
+
+// Pin change interrupt of A0 -> A5: vehicle detectors
+ISR(PCINT1_vect) {
+  stats.detectorChange(LIGHT_1, digitalRead(DETECTOR_L1) == LOW);
+  stats.detectorChange(LIGHT_2, digitalRead(DETECTOR_L2) == LOW);
+}
+
+
+template <class L1, class L2>
+void startStandardMode(L1& tf1, L2& tf2) {
+  Frame bodr1 = tf1.generateBitOrder();
+  Frame bodr2 = tf2.generateBitOrder();
+  stats.setSignal(LIGHT_1, tf1.getState());
+  stats.setSignal(LIGHT_2, tf2.getState());
 
   for(int i=0; i<TIMES_FLASH; i++) {
 
@@ -249,6 +308,7 @@ void startStandardMode(TrafficLight& tf1, TrafficLight& tf2) {
     tf2.show(bodr2, SECOND_DIGIT);
     delay(FLASH_MS);
 
+    stats.service();
     if(flagMode) return;
   }
   
@@ -260,11 +320,16 @@ void startStandardMode(TrafficLight& tf1, TrafficLight& tf2) {
 }
 
 
-void startBlinkYellowMode(TrafficLight tf1, TrafficLight tf2) {
+template <class L1, class L2>
+void startBlinkYellowMode(L1& tf1, L2& tf2) {
+  stats.setSignal(LIGHT_1, YELLOW);
+  stats.setSignal(LIGHT_2, YELLOW);
+
   tf1.controlYellow(ON);
   tf2.controlYellow(ON);
   for(int i=0; i<TIMES_FLASH; i++) {
     delay(FLASH_MS);
+    stats.service();
     if(flagMode) return;
   }
   
@@ -272,19 +337,22 @@ void startBlinkYellowMode(TrafficLight tf1, TrafficLight tf2) {
   tf2.controlYellow(OFF);
   for(int i=0; i<TIMES_FLASH; i++) {
     delay(FLASH_MS);
+    stats.service();
     if(flagMode) return;
   }
 }
 
 
-void setupTime(TrafficLight& tf, int state) {
+template <class Light>
+void setupTime(Light& tf, int state) {
   // save old state
   int oldTime = tf.getDisTime();
   int oldState = tf.getState();
   
   bool isChange = true;
   tf.setState(state);
-  BitOrder bdr;
+  Frame bdr;
+  int flash = 0;
 
   while (1) {
     if(isChange) {
@@ -299,6 +367,13 @@ void setupTime(TrafficLight& tf, int state) {
     tf.show(bdr, SECOND_DIGIT);
     delay(FLASH_MS);
 
+    // stays here until an interrupt: keep the statistics bins aligned, once per second
+    stats.service();
+    if(++flash >= TIMES_FLASH) {
+      flash = 0;
+      updateStats(rtc.now());
+    }
+
     if(digitalRead(BUTTON_UP) == 0) {
       while (digitalRead(BUTTON_UP) == 0);
       if(state == RED) tf.timeRedInc();
@@ -328,7 +403,7 @@ void startSetTimeAutoMode(TimeBox& tb) {
     tb.setDisTime(tb.getTimeGreen());
   }
 
-  BitOrder bdr = tb.generateBitOrder();
+  Frame bdr = tb.generateBitOrder();
   tb.show(bdr, FIRST_DIGIT);
   delay(FLASH_MS);
   tb.show(bdr, SECOND_DIGIT);
@@ -0,0 +1,423 @@
+// =================================================================================== //
+//                                fleet_sim.cpp
+// Host simulator: runs the light state machine of the firmware (TrafficLightT) for many
+// intersections with random vehicle arrivals, and reports queue length, delay and
+// throughput for every timing plan {timeRed, timeGreen, timeYellow} of a sweep.
+//
+// Build (from the repository root):
+//   g++ -std=c++17 -O2 -pthread -Itools/host -Ilib/TrafficLight -o fleet_sim
+//       tools/fleet_sim/fleet_sim.cpp
+//
+// Usage:
+//   ./fleet_sim [--intersections N] [--duration S] [--threads T] [--seed X]
+//               [--red FROM:TO:STEP] [--green FROM:TO:STEP] [--yellow FROM:TO:STEP] [--csv]
+//
+// Model (one step = one second, like startStandardMode()):
+//   - an intersection has 2 approaches, A runs the plan and starts RED,
+//     B runs the complement of the plan and starts GREEN, so they never both go
+//   - arrivals: Poisson, each approach has its own rate, drawn once per intersection
+//     (the same demand is used for every plan)
+//   - departures: one vehicle every SAT_HEADWAY_S seconds of GREEN or YELLOW
+//   - delay: vehicle-seconds spent in the queue / departed vehicles
+// =================================================================================== //
+
+#include <TrafficLightT.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// -------------------------------------------------------------
+//                        Constant
+// -------------------------------------------------------------
+#define    NUM_APPROACH         2
+#define    APPROACH_A           0
+#define    APPROACH_B           1
+#define    SAT_HEADWAY_S        2       // saturation flow: 1 vehicle / 2s / approach
+#define    CHUNK_SIZE           256     // intersections per task
+#define    MIN_RATE_A           0.05    // arrivals, vehicle/s
+#define    MAX_RATE_A           0.30
+#define    MIN_RATE_B           0.05
+#define    MAX_RATE_B           0.20
+
+
+// Timing plan, values as given to init() of the light of approach A
+// ======================================== //
+struct Plan {
+  int timeRed;
+  int timeGreen;
+  int timeYellow;
+};
+// ======================================== //
+
+
+// Result of a plan, summed over the fleet
+// ======================================== //
+struct PlanResult {
+  unsigned long long arrived;
+  unsigned long long departed;
+  unsigned long long waitSum;     // vehicle-seconds in queue
+  unsigned long long queueLeft;   // vehicles still queued at the end
+  unsigned int maxQueue;
+};
+// ======================================== //
+
+
+// Random number generator (xorshift32), one state per intersection
+// ======================================== //
+static inline uint32_t nextRandom(uint32_t& s) {
+  s ^= s << 13;
+  s ^= s >> 17;
+  s ^= s << 5;
+  return s;
+}
+
+static inline double uniform(uint32_t& s) {
+  return (nextRandom(s) >> 8) * (1.0 / 16777216.0);
+}
+
+static uint32_t seedOf(uint32_t seed, uint32_t i) {
+  uint32_t s = seed * 2654435761u ^ (i + 1) * 40503u;
+  return s ? s : 1;
+}
+// ======================================== //
+
+
+// State of a chunk of intersections, structure of arrays: the inner loop of a step
+// streams each array. Every intersection of a plan has the same signal, so the
+// lights (TrafficLightT, as in the firmware) run once per chunk into signal[].
+// One per worker thread, reused by every task it runs.
+// ======================================== //
+struct ChunkState {
+  std::vector<uint8_t> signal[NUM_APPROACH];      // light state at each second
+  double expRate[NUM_APPROACH][CHUNK_SIZE];       // exp(-rate), for Poisson sampling
+  uint32_t queue[NUM_APPROACH][CHUNK_SIZE];
+  uint32_t greenElapsed[NUM_APPROACH][CHUNK_SIZE];
+  uint32_t rng[CHUNK_SIZE];
+};
+// ======================================== //
+
+
+// Work-stealing thread pool
+// Each worker owns a deque: pops its own tasks from the back, steals from the front
+// of the other deques when empty. run() returns when every task is done.
+// ======================================== //
+class WorkStealingPool {
+    private:
+      struct Queue {
+        std::mutex lock;
+        std::deque<std::function<void()> > tasks;
+      };
+      std::vector<Queue> queues;
+      std::atomic<size_t> remaining;
+
+      bool pop(size_t self, std::function<void()>& task) {
+        Queue& q = queues[self];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if(q.tasks.empty()) return false;
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+      }
+
+      bool steal(size_t self, std::function<void()>& task) {
+        for(size_t k=1; k<queues.size(); k++) {
+          Queue& q = queues[(self + k) % queues.size()];
+          std::lock_guard<std::mutex> guard(q.lock);
+          if(q.tasks.empty()) continue;
+          task = std::move(q.tasks.front());
+          q.tasks.pop_front();
+          return true;
+        }
+        return false;
+      }
+
+      void work(size_t self) {
+        std::function<void()> task;
+        while(remaining.load() > 0) {
+          if(pop(self, task) || steal(self, task)) {
+            task();
+            remaining--;
+          } else {
+            std::this_thread::yield();
+          }
+        }
+      }
+
+    public:
+      explicit WorkStealingPool(size_t numThreads) : queues(numThreads), remaining(0) {}
+
+      // spread tasks round robin over the workers
+      void submit(std::function<void()> task) {
+        Queue& q = queues[remaining.load() % queues.size()];
+        q.tasks.push_back(std::move(task));
+        remaining++;
+      }
+
+      void run() {
+        std::vector<std::thread> threads;
+        for(size_t i=1; i<queues.size(); i++) {
+          threads.push_back(std::thread(&WorkStealingPool::work, this, i));
+        }
+        work(0);
+        for(size_t i=0; i<threads.size(); i++) {
+          threads[i].join();
+        }
+      }
+};
+// ======================================== //
+
+
+// Poisson arrivals in one second, expRate = exp(-rate)
+static inline uint32_t arrivals(uint32_t& s, double expRate) {
+  uint32_t k = 0;
+  double p = uniform(s);
+  while(p > expRate) {
+    k++;
+    p *= uniform(s);
+  }
+  return k;
+}
+
+
+// Simulate intersections [begin, end) (at most CHUNK_SIZE) for a plan
+// -------------------------------------------------------------------------------------
+static void simulate(int begin, int end, const Plan& plan, int duration, uint32_t seed, PlanResult& out) {
+  // same light type as the firmware, dummy board pins: the simulator never shows anything
+  typedef TrafficLightT< BoardConfig<0, 1, 2> > Light;
+  static thread_local ChunkState c;
+
+  // B: GREEN + YELLOW of B == RED of A, RED of B == GREEN + YELLOW of A
+  // (a phase of time t lasts t + 1 seconds: disTime counts t .. 0)
+  int redB = plan.timeGreen + plan.timeYellow + 1;
+  int greenB = plan.timeRed - plan.timeYellow - 1;
+
+  Light light[NUM_APPROACH];
+  light[APPROACH_A].init(plan.timeRed, plan.timeGreen, plan.timeYellow, RED);
+  light[APPROACH_B].init(redB, greenB, plan.timeYellow, GREEN);
+  for(int a=0; a<NUM_APPROACH; a++) {
+    c.signal[a].resize(duration);
+    for(int t=0; t<duration; t++) {
+      c.signal[a][t] = light[a].getState();
+      // one second of startStandardMode()
+      light[a].timeDecreaseOne();
+      if(light[a].isChangeState()) light[a].changeState();
+    }
+  }
+
+  int n = end - begin;
+  for(int i=0; i<n; i++) {
+    c.rng[i] = seedOf(seed, begin + i);
+    double rateA = MIN_RATE_A + (MAX_RATE_A - MIN_RATE_A) * uniform(c.rng[i]);
+    double rateB = MIN_RATE_B + (MAX_RATE_B - MIN_RATE_B) * uniform(c.rng[i]);
+    c.expRate[APPROACH_A][i] = exp(-rateA);
+    c.expRate[APPROACH_B][i] = exp(-rateB);
+    for(int a=0; a<NUM_APPROACH; a++) {
+      c.queue[a][i] = 0;
+      c.greenElapsed[a][i] = 0;
+    }
+  }
+
+  PlanResult r;
+  memset(&r, 0, sizeof(r));
+
+  for(int t=0; t<duration; t++) {
+    for(int a=0; a<NUM_APPROACH; a++) {
+      bool red = c.signal[a][t] == RED;
+      const double* expRate = c.expRate[a];
+      uint32_t* queue = c.queue[a];
+      uint32_t* greenElapsed = c.greenElapsed[a];
+      uint32_t* rng = c.rng;
+
+      for(int i=0; i<n; i++) {
+        uint32_t in = arrivals(rng[i], expRate[i]);
+        queue[i] += in;
+        r.arrived += in;
+
+        if(red) {
+          greenElapsed[i] = 0;
+        } else {
+          if(queue[i] > 0 && greenElapsed[i] % SAT_HEADWAY_S == 0) {
+            queue[i]--;
+            r.departed++;
+          }
+          greenElapsed[i]++;
+        }
+
+        r.waitSum += queue[i];
+        if(queue[i] > r.maxQueue) r.maxQueue = queue[i];
+      }
+    }
+  }
+
+  for(int a=0; a<NUM_APPROACH; a++) {
+    for(int i=0; i<n; i++) {
+      r.queueLeft += c.queue[a][i];
+    }
+  }
+  out = r;
+}
+
+
+// Parse "FROM:TO:STEP" or "VALUE"
+// -------------------------------------------------------------------------------------
+static bool parseRange(const char* s, std::vector<int>& values) {
+  int from, to, step;
+  int n = sscanf(s, "%d:%d:%d", &from, &to, &step);
+  if(n == 1) {
+    to = from;
+    step = 1;
+  } else if(n != 3 || step <= 0 || to < from) {
+    return false;
+  }
+  values.clear();
+  for(int v=from; v<=to; v+=step) {
+    values.push_back(v);
+  }
+  return true;
+}
+
+
+static void usage(const char* prog) {
+  fprintf(stderr,
+          "usage: %s [--intersections N] [--duration S] [--threads T] [--seed X]\n"
+          "          [--red FROM:TO:STEP] [--green FROM:TO:STEP] [--yellow FROM:TO:STEP] [--csv]\n",
+          prog);
+}
+
+
+int main(int argc, char** argv) {
+  int numIntersections = 1024;
+  int duration = 3600;
+  int numThreads = std::max(1u, std::thread::hardware_concurrency());
+  uint32_t seed = 1;
+  bool csv = false;
+  std::vector<int> reds, greens, yellows;
+  parseRange("20:80:10", reds);
+  parseRange("20:60:10", greens);
+  parseRange("3:5:1", yellows);
+
+  for(int i=1; i<argc; i++) {
+    const char* arg = argv[i];
+    const char* val = (i + 1 < argc) ? argv[i + 1] : NULL;
+    bool ok = true;
+    if(!strcmp(arg, "--csv")) {
+      csv = true;
+      continue;
+    } else if(!val) {
+      ok = false;
+    } else if(!strcmp(arg, "--intersections")) {
+      numIntersections = atoi(val);
+      ok = numIntersections > 0;
+    } else if(!strcmp(arg, "--duration")) {
+      duration = atoi(val);
+      ok = duration > 0;
+    } else if(!strcmp(arg, "--threads")) {
+      numThreads = atoi(val);
+      ok = numThreads > 0;
+    } else if(!strcmp(arg, "--seed")) {
+      seed = strtoul(val, NULL, 10);
+    } else if(!strcmp(arg, "--red")) {
+      ok = parseRange(val, reds);
+    } else if(!strcmp(arg, "--green")) {
+      ok = parseRange(val, greens);
+    } else if(!strcmp(arg, "--yellow")) {
+      ok = parseRange(val, yellows);
+    } else {
+      ok = false;
+    }
+    if(!ok) {
+      usage(argv[0]);
+      return 1;
+    }
+    i++;
+  }
+
+  // plans: B needs GREEN >= 0 => timeRed > timeYellow
+  std::vector<Plan> plans;
+  for(size_t r=0; r<reds.size(); r++) {
+    for(size_t g=0; g<greens.size(); g++) {
+      for(size_t y=0; y<yellows.size(); y++) {
+        Plan p = {reds[r], greens[g], yellows[y]};
+        if(p.timeRed > p.timeYellow && p.timeGreen >= 0 && p.timeYellow >= 0) plans.push_back(p);
+      }
+    }
+  }
+  if(plans.empty()) {
+    fprintf(stderr, "no valid plan (timeRed must be > timeYellow)\n");
+    return 1;
+  }
+
+  // one task per plan and chunk of intersections, the chunk state is per worker
+  int numChunks = (numIntersections + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  std::vector<PlanResult> partial(plans.size() * numChunks);
+  WorkStealingPool pool(numThreads);
+
+  for(size_t p=0; p<plans.size(); p++) {
+    for(int c=0; c<numChunks; c++) {
+      const Plan* plan = &plans[p];
+      PlanResult* out = &partial[p * numChunks + c];
+      int begin = c * CHUNK_SIZE;
+      int end = std::min(begin + CHUNK_SIZE, numIntersections);
+      pool.submit([=]() { simulate(begin, end, *plan, duration, seed, *out); });
+    }
+  }
+  pool.run();
+
+  // sum chunks, sort plans by average delay
+  std::vector<PlanResult> results(plans.size());
+  std::vector<size_t> order(plans.size());
+  for(size_t p=0; p<plans.size(); p++) {
+    PlanResult& r = results[p];
+    memset(&r, 0, sizeof(r));
+    for(int c=0; c<numChunks; c++) {
+      const PlanResult& part = partial[p * numChunks + c];
+      r.arrived += part.arrived;
+      r.departed += part.departed;
+      r.waitSum += part.waitSum;
+      r.queueLeft += part.queueLeft;
+      r.maxQueue = std::max(r.maxQueue, part.maxQueue);
+    }
+    order[p] = p;
+  }
+
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    double da = results[a].departed ? (double)results[a].waitSum / results[a].departed : 1e30;
+    double db = results[b].departed ? (double)results[b].waitSum / results[b].departed : 1e30;
+    return da < db;
+  });
+
+  double hours = duration / 3600.0;
+  double approachSeconds = (double)numIntersections * NUM_APPROACH * duration;
+  if(csv) {
+    printf("red,green,yellow,avg_queue,max_queue,avg_delay_s,throughput_vph,queue_left\n");
+  } else {
+    printf("%d intersections x %d s, %d threads, %zu plans\n\n", numIntersections, duration, numThreads, plans.size());
+    printf("%5s %5s %6s %10s %9s %12s %15s %10s\n",
+           "red", "green", "yellow", "avg queue", "max queue", "avg delay s", "veh/h/intersec", "queue left");
+  }
+  for(size_t k=0; k<order.size(); k++) {
+    const Plan& p = plans[order[k]];
+    const PlanResult& r = results[order[k]];
+    double avgQueue = r.waitSum / approachSeconds;
+    double avgDelay = r.departed ? (double)r.waitSum / r.departed : 0;
+    double throughput = r.departed / hours / numIntersections;
+    if(csv) {
+      printf("%d,%d,%d,%.3f,%u,%.2f,%.1f,%llu\n",
+             p.timeRed, p.timeGreen, p.timeYellow, avgQueue, r.maxQueue, avgDelay, throughput, r.queueLeft);
+    } else {
+      printf("%5d %5d %6d %10.2f %9u %12.1f %15.1f %10llu\n",
+             p.timeRed, p.timeGreen, p.timeYellow, avgQueue, r.maxQueue, avgDelay, throughput, r.queueLeft);
+    }
+  }
+  return 0;
+}
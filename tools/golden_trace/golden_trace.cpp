@@ -0,0 +1,639 @@
+// =================================================================================== //
+//                                golden_trace.cpp
+// Golden-trace regression harness: runs the unmodified firmware (src/main.cpp) on
+// virtual hardware, records every latch of the three 74HC595 chains with its
+// virtual time, and compares the run with the golden traces of the repository.
+//
+// Build (from the repository root):
+//   g++ -std=c++17 -O2 -Isrc -Itools/host -Ilib/TrafficLight -Ilib/TrafficStats -o golden_trace
+//       tools/golden_trace/golden_trace.cpp lib/TrafficLight/TrafficLight.cpp
+//       lib/TrafficStats/TrafficStats.cpp tools/host/Print.cpp tools/host/RTClib.cpp tools/host/EEPROM.cpp
+//
+// Usage:
+//   ./golden_trace [--dir DIR] [--tolerance-us N] [SCENARIO...]   compare with the golden traces
+//   ./golden_trace --record [--dir DIR] [SCENARIO...]             (re)write the golden traces
+//   ./golden_trace --list
+// DIR defaults to tools/golden_trace/golden. Exit code: 0 same behavior, 1 behavior
+// differs, 2 golden trace missing.
+//
+// Virtual hardware:
+//   - time only advances in delay(), delayMicroseconds() and in the I/O functions,
+//     by the cost of the call on a 16 MHz Uno (DIGITAL_WRITE_US ...)
+//   - the scenario script and its end run on the firmware clock: time without the
+//     cost of outputs. So a build with more or less bus time sees the interrupts and
+//     buttons in the same refresh slot, and runs the same number of slots
+//   - a chain shifts the bits given to shiftOut() into 16 bit and copies them to
+//     its outputs on the rising edge of STCP, like the 2 ICs
+//   - the RTC is fixed to the start time of the scenario, interrupts and buttons
+//     are driven by the scenario script
+//
+// Report:
+//   behavior: per chain, the sequence of output changes. Latches that do not change
+//             the outputs are not behavior. The drift of the change times is reported;
+//             it is an error only with --tolerance-us (bus time moves every later change).
+//             To find the origin of a timing change, compare the first drifting change.
+//   bus:      per chain, transactions, bytes shifted and time with STCP LOW;
+//             writes skipped by the dirty-frame tracking (BusStats, all chains).
+// =================================================================================== //
+
+#include "main.cpp"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+
+// -------------------------------------------------------------
+//                        Cost model (us)
+// -------------------------------------------------------------
+#define    DIGITAL_WRITE_US     5
+#define    DIGITAL_READ_US      5
+#define    SHIFT_BIT_US         (3 * DIGITAL_WRITE_US)    // data, clock HIGH, clock LOW
+#define    NUM_PIN              NUM_DIGITAL_PINS
+#define    NUM_CHAIN            3
+#define    MAX_REPORT           5
+
+
+// One latch of a chain
+// ======================================== //
+struct Latch {
+  unsigned long long t;   // virtual time of the rising edge of STCP (us)
+  uint16_t out;           // outputs: high byte = second IC (far), low byte = first IC
+  unsigned bytes;         // bytes shifted since the previous latch
+  unsigned busUs;         // time with STCP LOW
+};
+// ======================================== //
+
+
+// 2-IC 74HC595 chain
+// ======================================== //
+struct Chain {
+  const char* name;
+  int ds;
+  int stcp;
+  int shcp;
+  uint16_t shiftReg;
+  unsigned bytes;
+  unsigned long long lowAt;
+  std::vector<Latch> latches;
+};
+// ======================================== //
+
+
+// Scenario script
+// ======================================== //
+enum StepKind { IRQ, PIN_LOW, PIN_HIGH };
+
+struct Step {
+  unsigned long long at;  // firmware clock, us
+  StepKind kind;
+  int arg;                // interrupt number or pin
+};
+
+struct Scenario {
+  const char* name;
+  const char* description;
+  DateTime start;
+  unsigned long long durationUs;
+  std::vector<Step> steps;
+};
+// ======================================== //
+
+
+struct ScenarioEnd {};
+
+
+// -------------------------------------------------------------------------------------
+// Virtual hardware
+// -------------------------------------------------------------------------------------
+static unsigned long long vtime;    // timestamps, millis()
+static unsigned long long ftime;    // firmware clock: vtime without outputs, runs the script
+static unsigned long long endTime;
+static const std::vector<Step>* script;
+static size_t nextStep;
+static bool inStep;
+static int pinLevel[NUM_PIN];
+static void (*isrs[2])();
+
+static Chain chains[NUM_CHAIN] = {
+  {"L1", DS_PIN_L1, STCP_PIN_L1, SHCP_PIN_L1, 0, 0, 0, std::vector<Latch>()},
+  {"L2", DS_PIN_L2, STCP_PIN_L2, SHCP_PIN_L2, 0, 0, 0, std::vector<Latch>()},
+  {"TB", DS_PIN_TB, STCP_PIN_TB, SHCP_PIN_TB, 0, 0, 0, std::vector<Latch>()},
+};
+
+
+static void runSteps() {
+  while(!inStep && nextStep < script->size() && (*script)[nextStep].at <= ftime) {
+    const Step& s = (*script)[nextStep++];
+    inStep = true;
+    if(s.kind == IRQ) {
+      if(isrs[s.arg]) isrs[s.arg]();
+    } else {
+      pinLevel[s.arg] = (s.kind == PIN_HIGH) ? HIGH : LOW;
+    }
+    inStep = false;
+  }
+}
+
+
+static void advance(unsigned long long us) {
+  vtime += us;
+  ftime += us;
+  runSteps();
+  if(ftime >= endTime && !inStep) throw ScenarioEnd();
+}
+
+
+// outputs: only the timestamps move
+static void advanceOutput(unsigned long long us) {
+  vtime += us;
+}
+
+
+void pinMode(uint8_t, uint8_t) {}
+
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  for(int i=0; i<NUM_CHAIN; i++) {
+    Chain& c = chains[i];
+    if(c.stcp != pin) continue;
+    if(val == LOW) {
+      c.lowAt = vtime;
+    } else {
+      Latch l = {vtime + DIGITAL_WRITE_US, c.shiftReg, c.bytes, (unsigned)(vtime + DIGITAL_WRITE_US - c.lowAt)};
+      c.latches.push_back(l);
+      c.bytes = 0;
+    }
+  }
+  advanceOutput(DIGITAL_WRITE_US);
+}
+
+
+int digitalRead(uint8_t pin) {
+  advance(DIGITAL_READ_US);
+  return pinLevel[pin];
+}
+
+
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val) {
+  for(int i=0; i<NUM_CHAIN; i++) {
+    Chain& c = chains[i];
+    if(c.ds != dataPin || c.shcp != clockPin) continue;
+    for(int b=0; b<8; b++) {
+      int bit = (bitOrder == LSBFIRST) ? (val >> b) & 1 : (val >> (7 - b)) & 1;
+      c.shiftReg = (c.shiftReg << 1) | bit;
+    }
+    c.bytes++;
+  }
+  advanceOutput(8 * SHIFT_BIT_US);
+}
+
+
+void delay(unsigned long ms) { advance(ms * 1000ULL); }
+void delayMicroseconds(unsigned int us) { advance(us); }
+unsigned long millis() { return vtime / 1000; }
+unsigned long micros() { return vtime; }
+
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int) {
+  if(interruptNum < 2) isrs[interruptNum] = isr;
+}
+
+uint8_t SREG;
+uint8_t PCICR;
+uint8_t PCMSK1;
+void cli() {}
+void sei() {}
+
+
+// -------------------------------------------------------------------------------------
+// Scenarios
+// -------------------------------------------------------------------------------------
+#define    MS                   1000ULL
+#define    SEC                  1000000ULL
+#define    PRESS_MS             60      // button held
+#define    RELEASE_MS           140     // button released before the next press
+
+static unsigned long long irq(Scenario& sc, unsigned long long at, int num) {
+  Step s = {at, IRQ, num};
+  sc.steps.push_back(s);
+  return at;
+}
+
+// press a button n times from "at", return the time after the last release
+static unsigned long long press(Scenario& sc, unsigned long long at, int pin, int n) {
+  for(int i=0; i<n; i++) {
+    Step down = {at, PIN_LOW, pin};
+    Step up = {at + PRESS_MS * MS, PIN_HIGH, pin};
+    sc.steps.push_back(down);
+    sc.steps.push_back(up);
+    at += (PRESS_MS + RELEASE_MS) * MS;
+  }
+  return at;
+}
+
+// INT0: changeMode(), INT1: changeLightNumber()
+static unsigned long long nextMode(Scenario& sc, unsigned long long at, int n) {
+  for(int i=0; i<n; i++) irq(sc, at + i * 50 * MS, 0);
+  return at + n * 50 * MS;
+}
+
+
+static std::vector<Scenario> scenarios() {
+  std::vector<Scenario> list;
+  DateTime day(2026, 1, 15, 12, 0, 0);
+  DateTime night(2026, 1, 15, 23, 0, 0);
+
+  // Both lights through complete cycles: L1 120 s, L2 56 s
+  Scenario cycle = {"full_cycle", "STANDARD_MODE, RED -> GREEN -> YELLOW -> RED of both lights",
+                    day, 125 * SEC, std::vector<Step>()};
+  list.push_back(cycle);
+
+  // Every mode in order with the changeMode() / changeLightNumber() interrupts
+  Scenario modes = {"mode_switch", "all modes through the INT0 / INT1 interrupts, setup edits in each",
+                    day, 0, std::vector<Step>()};
+  unsigned long long t = 3 * SEC;
+  t = nextMode(modes, t, 1) + 3 * SEC;                     // YELLOW_BLINK_MODE
+  t = nextMode(modes, t, 1) + 3 * SEC;                     // AUTO_MODE (12h => standard)
+  t = nextMode(modes, t, 1) + 1 * SEC;                     // SET_TIME_AUTO, START
+  t = press(modes, t, BUTTON_UP, 2) + 1 * SEC;
+  t = irq(modes, t, 1) + 1 * SEC;                          // END
+  t = press(modes, t, BUTTON_DOWN, 3) + 1 * SEC;
+  t = nextMode(modes, t, 1) + 1 * SEC;                     // SETUP_RED, LIGHT_2
+  t = press(modes, t, BUTTON_DOWN, 2) + 1 * SEC;
+  t = irq(modes, t, 1) + 1 * SEC;                          // LIGHT_1
+  t = press(modes, t, BUTTON_UP, 2) + 1 * SEC;
+  t = nextMode(modes, t, 1) + 1 * SEC;                     // SETUP_GREEN
+  t = press(modes, t, BUTTON_UP, 1) + 1 * SEC;
+  t = nextMode(modes, t, 1) + 5 * SEC;                     // STANDARD_MODE
+  modes.durationUs = t;
+  list.push_back(modes);
+
+  // Red time of L1 edited above 99: the display wraps (disTime > 99 => disTime - 100)
+  Scenario wrap = {"setup_red_wrap", "SETUP_RED of L1 to 103, then STANDARD_MODE until L1 is RED",
+                   day, 0, std::vector<Step>()};
+  t = nextMode(wrap, 1 * SEC, 4) + 1 * SEC;                // SETUP_RED, LIGHT_1
+  t = press(wrap, t, BUTTON_UP, 35) + 1 * SEC;
+  t = nextMode(wrap, t, 2) + 130 * SEC;                    // SETUP_GREEN -> STANDARD_MODE
+  wrap.durationUs = t;
+  list.push_back(wrap);
+
+  // AUTO_MODE at night: blink YELLOW
+  Scenario autoNight = {"auto_night", "AUTO_MODE at 23h => YELLOW_BLINK_MODE", night, 0, std::vector<Step>()};
+  autoNight.durationUs = nextMode(autoNight, 1 * SEC, 2) + 5 * SEC;
+  list.push_back(autoNight);
+
+  return list;
+}
+
+
+// Run a scenario in this process: setup(), then loop() until the end
+static void runScenario(const Scenario& sc) {
+  vtime = 0;
+  ftime = 0;
+  endTime = sc.durationUs;
+  script = &sc.steps;
+  nextStep = 0;
+  inStep = false;
+  for(int i=0; i<NUM_PIN; i++) pinLevel[i] = HIGH;
+  RTC_DS1307::hostSetTime(sc.start, true);
+
+  try {
+    setup();
+    while(1) loop();
+  } catch(const ScenarioEnd&) {
+  }
+}
+
+
+// -------------------------------------------------------------------------------------
+// Trace file
+// One section per chain, one line per latch: +dt out bytes bus_us
+// dt is from the previous latch of the chain, out is 4 hex digits.
+// "* P N": the previous P lines repeat for N more latches.
+// -------------------------------------------------------------------------------------
+struct Item {
+  unsigned long long dt;
+  uint16_t out;
+  unsigned bytes;
+  unsigned busUs;
+  bool operator==(const Item& o) const {
+    return dt == o.dt && out == o.out && bytes == o.bytes && busUs == o.busUs;
+  }
+};
+
+
+static std::vector<Item> toItems(const std::vector<Latch>& latches) {
+  std::vector<Item> items;
+  unsigned long long last = 0;
+  for(size_t i=0; i<latches.size(); i++) {
+    Item it = {latches[i].t - last, latches[i].out, latches[i].bytes, latches[i].busUs};
+    items.push_back(it);
+    last = latches[i].t;
+  }
+  return items;
+}
+
+
+static std::string encode(const Scenario& sc) {
+  std::string s;
+  char line[128];
+  snprintf(line, sizeof(line), "# %s: %s\n# duration_us %llu\n# skipped_writes %lu\n",
+           sc.name, sc.description, sc.durationUs, BusStats::skippedWrites);
+  s += line;
+
+  for(int c=0; c<NUM_CHAIN; c++) {
+    std::vector<Item> items = toItems(chains[c].latches);
+    snprintf(line, sizeof(line), "chain %s\n", chains[c].name);
+    s += line;
+
+    size_t i = 0;
+    while(i < items.size()) {
+      // longest repeat of the previous 1 or 2 lines
+      size_t best = 0, bestPeriod = 0;
+      for(size_t p=1; p<=2 && p<=i; p++) {
+        size_t n = 0;
+        while(i + n < items.size() && items[i + n] == items[i + n - p]) n++;
+        if(n > best) {
+          best = n;
+          bestPeriod = p;
+        }
+      }
+      if(best >= 2) {
+        snprintf(line, sizeof(line), "* %zu %zu\n", bestPeriod, best);
+        i += best;
+      } else {
+        snprintf(line, sizeof(line), "+%llu %04x %u %u\n", items[i].dt, items[i].out, items[i].bytes, items[i].busUs);
+        i++;
+      }
+      s += line;
+    }
+  }
+  return s;
+}
+
+
+// Parse a trace into the latches of each chain and the skipped writes, false if malformed
+static bool decode(const std::string& text, std::vector<Latch> out[NUM_CHAIN], unsigned long& skipped) {
+  int c = -1;
+  skipped = 0;
+  std::vector<Item> items[NUM_CHAIN];
+  size_t pos = 0;
+
+  while(pos < text.size()) {
+    size_t eol = text.find('\n', pos);
+    if(eol == std::string::npos) eol = text.size();
+    std::string line = text.substr(pos, eol - pos);
+    pos = eol + 1;
+
+    char name[16];
+    unsigned long long dt;
+    unsigned o, bytes, busUs;
+    size_t period, n;
+    if(line.empty() || line[0] == '#') {
+      sscanf(line.c_str(), "# skipped_writes %lu", &skipped);
+      continue;
+    } else if(sscanf(line.c_str(), "chain %15s", name) == 1) {
+      c = -1;
+      for(int i=0; i<NUM_CHAIN; i++) {
+        if(!strcmp(chains[i].name, name)) c = i;
+      }
+      if(c < 0) return false;
+    } else if(c >= 0 && sscanf(line.c_str(), "+%llu %x %u %u", &dt, &o, &bytes, &busUs) == 4) {
+      Item it = {dt, (uint16_t)o, bytes, busUs};
+      items[c].push_back(it);
+    } else if(c >= 0 && sscanf(line.c_str(), "* %zu %zu", &period, &n) == 2) {
+      if(period == 0 || period > items[c].size()) return false;
+      for(size_t k=0; k<n; k++) {
+        items[c].push_back(items[c][items[c].size() - period]);
+      }
+    } else {
+      return false;
+    }
+  }
+
+  for(int i=0; i<NUM_CHAIN; i++) {
+    unsigned long long t = 0;
+    out[i].clear();
+    for(size_t k=0; k<items[i].size(); k++) {
+      t += items[i][k].dt;
+      Latch l = {t, items[i][k].out, items[i][k].bytes, items[i][k].busUs};
+      out[i].push_back(l);
+    }
+  }
+  return true;
+}
+
+
+// Run a scenario in a child process (the firmware keeps its state in globals)
+static bool record(const Scenario& sc, std::string& trace) {
+  int fd[2];
+  if(pipe(fd) != 0) return false;
+
+  pid_t pid = fork();
+  if(pid < 0) return false;
+  if(pid == 0) {
+    close(fd[0]);
+    runScenario(sc);
+    std::string s = encode(sc);
+    size_t done = 0;
+    while(done < s.size()) {
+      ssize_t n = write(fd[1], s.data() + done, s.size() - done);
+      if(n <= 0) _exit(1);
+      done += n;
+    }
+    _exit(0);
+  }
+
+  close(fd[1]);
+  trace.clear();
+  char buf[65536];
+  ssize_t n;
+  while((n = read(fd[0], buf, sizeof(buf))) > 0) trace.append(buf, n);
+  close(fd[0]);
+
+  int status;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+
+static bool readFile(const std::string& path, std::string& text) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if(!f) return false;
+  char buf[65536];
+  size_t n;
+  text.clear();
+  while((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+
+static bool writeFile(const std::string& path, const std::string& text) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if(!f) return false;
+  bool ok = fwrite(text.data(), 1, text.size(), f) == text.size();
+  return fclose(f) == 0 && ok;
+}
+
+
+// -------------------------------------------------------------------------------------
+// Compare
+// -------------------------------------------------------------------------------------
+static std::vector<Latch> changes(const std::vector<Latch>& latches) {
+  std::vector<Latch> result;
+  for(size_t i=0; i<latches.size(); i++) {
+    if(result.empty() || latches[i].out != result.back().out) result.push_back(latches[i]);
+  }
+  return result;
+}
+
+
+// return true if the behavior of the chain is the same
+static bool compareChain(const char* name, const std::vector<Latch>& golden, const std::vector<Latch>& now,
+                         unsigned long long tolerance) {
+  std::vector<Latch> g = changes(golden);
+  std::vector<Latch> n = changes(now);
+  size_t common = g.size() < n.size() ? g.size() : n.size();
+  long long maxDrift = 0;
+  int reported = 0;
+  bool same = g.size() == n.size();
+
+  for(size_t i=0; i<common; i++) {
+    long long drift = (long long)n[i].t - (long long)g[i].t;
+    if(llabs(drift) > llabs(maxDrift)) maxDrift = drift;
+    if(g[i].out != n[i].out) {
+      printf("    %s: change #%zu at %.6f s: golden %04x, now %04x (at %.6f s)\n",
+             name, i, g[i].t / 1e6, g[i].out, n[i].out, n[i].t / 1e6);
+      same = false;
+      break;  // the rest of the sequence is shifted
+    }
+    if((unsigned long long)llabs(drift) > tolerance) {
+      if(reported++ < MAX_REPORT) {
+        printf("    %s: change #%zu to %04x: golden %.6f s, now %.6f s (%+lld us)\n",
+               name, i, g[i].out, g[i].t / 1e6, n[i].t / 1e6, drift);
+      }
+      same = false;
+    }
+  }
+  if(g.size() != n.size()) {
+    printf("    %s: %zu output changes in golden, %zu now\n", name, g.size(), n.size());
+  }
+  printf("    %-4s %9zu changes   max drift %+lld us\n", name, n.size(), maxDrift);
+  return same;
+}
+
+
+static void busTotals(const std::vector<Latch>& latches, unsigned long long& bytes, unsigned long long& busUs) {
+  bytes = 0;
+  busUs = 0;
+  for(size_t i=0; i<latches.size(); i++) {
+    bytes += latches[i].bytes;
+    busUs += latches[i].busUs;
+  }
+}
+
+
+static void compareBus(const char* name, const std::vector<Latch>& golden, const std::vector<Latch>& now) {
+  unsigned long long gBytes, gUs, nBytes, nUs;
+  busTotals(golden, gBytes, gUs);
+  busTotals(now, nBytes, nUs);
+  double pct = gUs ? 100.0 * ((double)nUs - (double)gUs) / gUs : 0;
+  printf("    %-4s %9zu -> %-9zu %9llu -> %-9llu %11llu -> %-11llu %+7.1f%%\n",
+         name, golden.size(), now.size(), gBytes, nBytes, gUs, nUs, pct);
+}
+
+
+static void usage(const char* prog) {
+  fprintf(stderr, "usage: %s [--record] [--list] [--dir DIR] [--tolerance-us N] [SCENARIO...]\n", prog);
+}
+
+
+int main(int argc, char** argv) {
+  std::string dir = "tools/golden_trace/golden";
+  unsigned long long tolerance = ULLONG_MAX;   // timing drift is reported, not checked
+  bool recordMode = false;
+  bool list = false;
+  std::vector<std::string> names;
+
+  for(int i=1; i<argc; i++) {
+    if(!strcmp(argv[i], "--record")) {
+      recordMode = true;
+    } else if(!strcmp(argv[i], "--list")) {
+      list = true;
+    } else if(!strcmp(argv[i], "--dir") && i + 1 < argc) {
+      dir = argv[++i];
+    } else if(!strcmp(argv[i], "--tolerance-us") && i + 1 < argc) {
+      tolerance = strtoull(argv[++i], NULL, 10);
+    } else if(argv[i][0] == '-') {
+      usage(argv[0]);
+      return 2;
+    } else {
+      names.push_back(argv[i]);
+    }
+  }
+
+  std::vector<Scenario> all = scenarios();
+  if(list) {
+    for(size_t i=0; i<all.size(); i++) printf("%-16s %s\n", all[i].name, all[i].description);
+    return 0;
+  }
+
+  int result = 0;
+  for(size_t i=0; i<all.size(); i++) {
+    const Scenario& sc = all[i];
+    if(!names.empty()) {
+      bool wanted = false;
+      for(size_t k=0; k<names.size(); k++) wanted = wanted || names[k] == sc.name;
+      if(!wanted) continue;
+    }
+
+    std::string path = dir + "/" + sc.name + ".trace";
+    std::string trace;
+    if(!record(sc, trace)) {
+      printf("%-16s run failed\n", sc.name);
+      result = 2;
+      continue;
+    }
+
+    if(recordMode) {
+      if(!writeFile(path, trace)) {
+        printf("%-16s cannot write %s\n", sc.name, path.c_str());
+        result = 2;
+      } else {
+        printf("%-16s recorded %s\n", sc.name, path.c_str());
+      }
+      continue;
+    }
+
+    std::string goldenText;
+    std::vector<Latch> golden[NUM_CHAIN], now[NUM_CHAIN];
+    unsigned long goldenSkipped, nowSkipped;
+    if(!readFile(path, goldenText) || !decode(goldenText, golden, goldenSkipped)) {
+      printf("%-16s no golden trace %s\n", sc.name, path.c_str());
+      result = 2;
+      continue;
+    }
+    decode(trace, now, nowSkipped);
+
+    printf("%s\n  behavior:\n", sc.name);
+    bool same = true;
+    for(int c=0; c<NUM_CHAIN; c++) {
+      same = compareChain(chains[c].name, golden[c], now[c], tolerance) && same;
+    }
+    printf("  bus:  transactions golden -> now, bytes, STCP LOW us\n");
+    for(int c=0; c<NUM_CHAIN; c++) {
+      compareBus(chains[c].name, golden[c], now[c]);
+    }
+    printf("    skipped writes %lu -> %lu\n", goldenSkipped, nowSkipped);
+    printf("  => %s\n\n", same ? "same behavior" : "BEHAVIOR DIFFERS");
+    if(!same && result == 0) result = 1;
+  }
+  return result;
+}
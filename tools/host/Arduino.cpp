@@ -0,0 +1,24 @@
+#include "Arduino.h"
+
+// =================================================================================== //
+//                                Arduino.cpp (host)
+// Arduino core without hardware: outputs are dropped, inputs read HIGH
+// (buttons released), time does not advance.
+// =================================================================================== //
+
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return HIGH; }
+void shiftOut(uint8_t, uint8_t, uint8_t, uint8_t) {}
+void delay(unsigned long) {}
+void delayMicroseconds(unsigned int) {}
+unsigned long millis() { return 0; }
+unsigned long micros() { return 0; }
+void attachInterrupt(uint8_t, void (*)(), int) {}
+
+uint8_t SREG;
+uint8_t PCICR;
+uint8_t PCMSK1;
+void cli() {}
+void sei() {}
@@ -0,0 +1,104 @@
+#ifndef _HOST_ARDUINO_
+#define _HOST_ARDUINO_
+
+// =================================================================================== //
+//                                Arduino.h (host)
+// Minimal Arduino core for building the TrafficLight library on a PC.
+// Only what the firmware uses is declared; the I/O functions are defined by the
+// tool that links the library (Arduino.cpp: no hardware, or a recording one).
+// =================================================================================== //
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define   HIGH              1
+#define   LOW               0
+#define   INPUT             0
+#define   OUTPUT            1
+#define   INPUT_PULLUP      2
+#define   LSBFIRST          0
+#define   MSBFIRST          1
+#define   CHANGE            1
+#define   FALLING           2
+#define   RISING            3
+#define   NUM_DIGITAL_PINS  20      // Uno
+#define   A0                14
+#define   A1                15
+
+// Program memory is ordinary memory on the host
+#define   PROGMEM
+#define   pgm_read_byte(addr)   (*(const uint8_t*)(addr))
+#define   pgm_read_word(addr)   (*(const uint16_t*)(addr))
+
+// Binary constants used by the firmware (binary.h)
+#define   B00000000         0x00
+#define   B00000001         0x01
+#define   B00000100         0x04
+#define   B00000110         0x06
+#define   B00001111         0x0F
+#define   B00010010         0x12
+#define   B00100000         0x20
+#define   B00100100         0x24
+#define   B01001100         0x4C
+#define   B01001111         0x4F
+
+#define   digitalPinToInterrupt(p)  ((p) == 2 ? 0 : ((p) == 3 ? 1 : -1))
+
+// AVR registers and interrupt control used by the firmware
+#define   _BV(b)            (1 << (b))
+#define   PCIE1             1
+#define   PCINT8            0
+#define   PCINT9            1
+#define   ISR(vector)       void vector()
+extern uint8_t SREG;
+extern uint8_t PCICR;
+extern uint8_t PCMSK1;
+void cli();
+void sei();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long millis();
+unsigned long micros();
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int mode);
+
+
+// Print: text output, Serial goes to stdout
+// ======================================== //
+#define   F(s)              (s)
+
+class Print {
+    public:
+      virtual ~Print() {}
+      virtual size_t write(uint8_t c) = 0;
+      size_t print(const char* s);
+      size_t print(char c);
+      size_t print(long v);
+      size_t print(int v) { return print((long)v); }
+      size_t print(unsigned long v);
+      size_t print(unsigned int v) { return print((unsigned long)v); }
+      size_t println(const char* s);
+      size_t println(long v);
+      size_t println(int v) { return println((long)v); }
+      size_t println(unsigned int v) { return println((long)v); }
+      size_t println(unsigned long v);
+};
+
+class HardwareSerial : public Print {
+    public:
+      void begin(unsigned long) {}
+      virtual size_t write(uint8_t c);
+};
+
+extern HardwareSerial Serial;
+// ======================================== //
+
+#endif // _HOST_ARDUINO_
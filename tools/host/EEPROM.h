@@ -0,0 +1,49 @@
+#ifndef _HOST_EEPROM_
+#define _HOST_EEPROM_
+
+#include "Arduino.h"
+
+// =================================================================================== //
+//                                EEPROM.h (host)
+// 1 KB EEPROM of the Uno in memory, erased (0xFF) at start
+// writes per cell are counted (wear), update() writes only a changed value
+// =================================================================================== //
+
+#define   EEPROM_SIZE       1024
+
+class EEPROMClass {
+    private:
+      uint8_t data[EEPROM_SIZE];
+      uint32_t writes[EEPROM_SIZE];
+
+    public:
+      EEPROMClass() {
+        memset(data, 0xFF, sizeof(data));
+        memset(writes, 0, sizeof(writes));
+      }
+      uint8_t read(int addr) { return data[addr]; }
+      void write(int addr, uint8_t v) {
+        data[addr] = v;
+        writes[addr]++;
+      }
+      void update(int addr, uint8_t v) {
+        if(data[addr] != v) write(addr, v);
+      }
+      uint16_t length() { return EEPROM_SIZE; }
+
+      uint32_t hostWrites(int addr) { return writes[addr]; }
+
+      template <typename T> T& get(int addr, T& t) {
+        memcpy(&t, data + addr, sizeof(T));
+        return t;
+      }
+
+      template <typename T> const T& put(int addr, const T& t) {
+        memcpy(data + addr, &t, sizeof(T));
+        return t;
+      }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // _HOST_EEPROM_
@@ -0,0 +1,56 @@
+#include "Arduino.h"
+#include <stdio.h>
+
+// =================================================================================== //
+//                                Print.cpp (host)
+// Print and Serial of the host Arduino core, Serial writes to stdout
+// =================================================================================== //
+
+
+size_t Print::print(const char* s) {
+  size_t n = 0;
+  while(*s) n += write(*s++);
+  return n;
+}
+
+
+size_t Print::print(char c) {
+  return write(c);
+}
+
+
+size_t Print::print(long v) {
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%ld", v);
+  return print((const char*)buf);
+}
+
+
+size_t Print::print(unsigned long v) {
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%lu", v);
+  return print((const char*)buf);
+}
+
+
+size_t Print::println(const char* s) {
+  return print(s) + print('\n');
+}
+
+
+size_t Print::println(long v) {
+  return print(v) + print('\n');
+}
+
+
+size_t Print::println(unsigned long v) {
+  return print(v) + print('\n');
+}
+
+
+size_t HardwareSerial::write(uint8_t c) {
+  return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+
+HardwareSerial Serial;
@@ -0,0 +1,100 @@
+#include "RTClib.h"
+#include <stdio.h>
+#include <string.h>
+
+// =================================================================================== //
+//                                RTClib.cpp (host)
+// =================================================================================== //
+
+static uint32_t setTime = SECONDS_FROM_1970_TO_2000;   // RTC time at setMillis
+static unsigned long setMillis = 0;
+static bool locked = false;
+static bool running = false;                              // oscillator started (time set)
+
+
+// days since 1970-01-01 of a civil date
+static long daysFromCivil(long y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  long era = (y >= 0 ? y : y - 399) / 400;
+  unsigned yoe = (unsigned)(y - era * 400);
+  unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + (long)doe - 719468;
+}
+
+
+static void civilFromDays(long z, long& y, unsigned& m, unsigned& d) {
+  z += 719468;
+  long era = (z >= 0 ? z : z - 146096) / 146097;
+  unsigned doe = (unsigned)(z - era * 146097);
+  unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  unsigned mp = (5 * doy + 2) / 153;
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp < 10 ? mp + 3 : mp - 9;
+  y = (long)yoe + era * 400 + (m <= 2);
+}
+
+
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t min, uint8_t sec) {
+  t = daysFromCivil(year, month, day) * 86400UL + hour * 3600UL + min * 60UL + sec;
+}
+
+
+DateTime::DateTime(const char* date, const char* time) {
+  static const char MONTHS[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+  char mon[4] = {0};
+  int day = 1, year = 2000, hour = 0, min = 0, sec = 0;
+  sscanf(date, "%3s %d %d", mon, &day, &year);
+  sscanf(time, "%d:%d:%d", &hour, &min, &sec);
+  const char* p = strstr(MONTHS, mon);
+  int month = p ? (int)(p - MONTHS) / 3 + 1 : 1;
+  *this = DateTime(year, month, day, hour, min, sec);
+}
+
+
+uint16_t DateTime::year() const {
+  long y; unsigned m, d;
+  civilFromDays(t / 86400, y, m, d);
+  return y;
+}
+
+
+uint8_t DateTime::month() const {
+  long y; unsigned m, d;
+  civilFromDays(t / 86400, y, m, d);
+  return m;
+}
+
+
+uint8_t DateTime::day() const {
+  long y; unsigned m, d;
+  civilFromDays(t / 86400, y, m, d);
+  return d;
+}
+
+
+void RTC_DS1307::adjust(const DateTime& dt) {
+  if(locked) return;
+  setTime = dt.unixtime();
+  setMillis = millis();
+  running = true;
+}
+
+
+bool RTC_DS1307::isrunning() {
+  return running;
+}
+
+
+DateTime RTC_DS1307::now() {
+  return DateTime(setTime + (millis() - setMillis) / 1000);
+}
+
+
+void RTC_DS1307::hostSetTime(const DateTime& dt, bool lock) {
+  setTime = dt.unixtime();
+  setMillis = millis();
+  running = true;
+  locked = lock;
+}
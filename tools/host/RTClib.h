@@ -0,0 +1,52 @@
+#ifndef _HOST_RTCLIB_
+#define _HOST_RTCLIB_
+
+#include "Arduino.h"
+
+// =================================================================================== //
+//                                RTClib.h (host)
+// DateTime and RTC_DS1307 as used by the firmware, the RTC runs on millis()
+// =================================================================================== //
+
+#define   SECONDS_FROM_1970_TO_2000   946684800UL
+
+
+// class DateTime declare
+// ======================================== //
+class DateTime {
+    private:
+      uint32_t t;     // unix time
+
+    public:
+      DateTime(uint32_t unixTime = SECONDS_FROM_1970_TO_2000) : t(unixTime) {}
+      DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t min = 0, uint8_t sec = 0);
+      DateTime(const char* date, const char* time);   // __DATE__, __TIME__
+
+      uint16_t year() const;
+      uint8_t month() const;
+      uint8_t day() const;
+      uint8_t hour() const { return (t / 3600) % 24; }
+      uint8_t minute() const { return (t / 60) % 60; }
+      uint8_t second() const { return t % 60; }
+      uint32_t unixtime() const { return t; }
+      long secondstime() const { return t - SECONDS_FROM_1970_TO_2000; }
+};
+// ======================================== //
+
+
+// class RTC_DS1307 declare
+// adjust() is ignored while the time is locked by hostSetTime(), so that a
+// recorded run does not depend on the build date
+// ======================================== //
+class RTC_DS1307 {
+    public:
+      bool begin() { return true; }
+      bool isrunning();
+      void adjust(const DateTime& dt);
+      DateTime now();
+
+      static void hostSetTime(const DateTime& dt, bool lock);
+};
+// ======================================== //
+
+#endif // _HOST_RTCLIB_
@@ -0,0 +1,9 @@
+#ifndef _HOST_WIRE_
+#define _HOST_WIRE_
+
+// =================================================================================== //
+//                                Wire.h (host)
+// Empty: the RTC of the host core (RTClib.h) does not use I2C
+// =================================================================================== //
+
+#endif // _HOST_WIRE_
@@ -0,0 +1,365 @@
+// =================================================================================== //
+//                                stats_check.cpp
+// Host check of TrafficStats: drives detectorChange()/setSignal()/update()/service()
+// with a virtual clock and an in-memory EEPROM, and compares exportBins() output
+// with the expected CSV.
+//
+// Build (from the repository root):
+//   g++ -std=c++17 -O2 -Itools/host -Ilib/TrafficLight -Ilib/TrafficStats -o stats_check
+//       tools/stats_check/stats_check.cpp lib/TrafficStats/TrafficStats.cpp
+//       tools/host/Print.cpp tools/host/RTClib.cpp tools/host/EEPROM.cpp
+//
+// Usage:
+//   ./stats_check          exit code: 0 all checks pass, 1 a check failed
+// =================================================================================== //
+
+#include <TrafficStats.h>
+#include <EEPROM.h>
+
+#include <cstdio>
+#include <string>
+
+
+// -------------------------------------------------------------
+//                 Virtual Arduino core
+// millis() is the virtual clock, interrupts are not simulated
+// -------------------------------------------------------------
+static unsigned long nowMs = 0;
+
+unsigned long millis() { return nowMs; }
+uint8_t SREG;
+void cli() {}
+void sei() {}
+
+
+// Print to a string
+// ======================================== //
+class CapturePrint : public Print {
+    public:
+      std::string text;
+      virtual size_t write(uint8_t c) {
+        text += (char)c;
+        return 1;
+      }
+};
+// ======================================== //
+
+
+// -------------------------------------------------------------
+//                        Helpers
+// -------------------------------------------------------------
+#define   HEADER            "start,approach,count,occupancy_pct,red_arrivals\n"
+#define   BIN_S             (BIN_15_MIN * 60UL)
+
+static int failures = 0;
+static uint32_t unixNow;      // RTC time of the running firmware
+
+
+static void check(bool ok, const char* name, const std::string& got = "", const std::string& want = "") {
+  printf("%-40s %s\n", name, ok ? "ok" : "FAILED");
+  if(!ok) {
+    failures++;
+    if(!want.empty() || !got.empty()) printf("--- want\n%s--- got\n%s---\n", want.c_str(), got.c_str());
+  }
+}
+
+
+// Erased EEPROM, as on a new board
+static void eraseEeprom() {
+  for(int i=0; i<EEPROM_SIZE; i++) EEPROM.write(i, 0xFF);
+}
+
+
+// Power-on at a time of 2024 (day of March, hh:mm:ss)
+static void boot(TrafficStats& stats, uint8_t day, uint8_t hour, uint8_t min, uint8_t sec = 0) {
+  unixNow = DateTime(2024, 3, day, hour, min, sec).unixtime();
+  stats.init(BIN_15_MIN, DateTime(unixNow));
+}
+
+
+// Advance the clock second by second, like loop(): update() then service()
+static int run(TrafficStats& stats, uint32_t seconds) {
+  int closed = 0;
+  for(uint32_t i=0; i<seconds; i++) {
+    unixNow++;
+    nowMs += 1000;
+    if(stats.update(DateTime(unixNow))) closed++;
+    stats.service();
+  }
+  return closed;
+}
+
+
+// Advance the clock without calling update() (firmware busy elsewhere)
+static void stall(uint32_t seconds) {
+  unixNow += seconds;
+  nowMs += seconds * 1000;
+}
+
+
+// Run up to the next bin boundary and store the bin
+static void closeBin(TrafficStats& stats) {
+  run(stats, BIN_S - (unixNow % BIN_S));
+  run(stats, 20);
+}
+
+
+// A vehicle over the detector of an approach for some seconds
+static void vehicle(TrafficStats& stats, uint8_t approach, uint32_t seconds) {
+  stats.detectorChange(approach, true);
+  run(stats, seconds);
+  stats.detectorChange(approach, false);
+}
+
+
+static std::string exportBins(TrafficStats& stats) {
+  CapturePrint out;
+  stats.exportBins(out);
+  return out.text;
+}
+
+
+// CSV lines of a bin with no traffic
+static std::string emptyBin(uint32_t unixStart) {
+  DateTime t(unixStart);
+  char line[64];
+  std::string s;
+  for(int i=1; i<=NUM_APPROACH; i++) {
+    snprintf(line, sizeof(line), "%04d-%02d-%02d %02d:%02d,%d,0,0.0,0\n",
+             t.year(), t.month(), t.day(), t.hour(), t.minute(), i);
+    s += line;
+  }
+  return s;
+}
+
+
+static size_t countLines(const std::string& s) {
+  size_t n = 0;
+  for(size_t i=0; i<s.size(); i++) n += s[i] == '\n';
+  return n;
+}
+
+
+// -------------------------------------------------------------
+//                        Checks
+// -------------------------------------------------------------
+
+// Boot at 10:07: the first bin is 10:00 but counts only 8 minutes,
+// occupancy is relative to the time counted
+static void checkPartialFirstBin() {
+  eraseEeprom();
+  TrafficStats stats;
+  boot(stats, 1, 10, 7);
+  check(exportBins(stats) == HEADER, "empty ring exports the header only");
+
+  run(stats, 60);
+  stats.setSignal(0, RED);
+  vehicle(stats, 0, 48);                   // 48 s of 480 s: 10%
+  stats.setSignal(0, GREEN);
+  vehicle(stats, 1, 3);
+  vehicle(stats, 1, 3);
+  check(run(stats, BIN_S) == 1, "update() closes one bin at 10:15");
+  run(stats, 20);
+
+  std::string want = HEADER
+    "2024-03-01 10:00,1,1,10.0,1\n"
+    "2024-03-01 10:00,2,2,1.0,0\n";
+  std::string got = exportBins(stats);
+  check(got == want, "partial first bin", got, want);
+
+  CapturePrint last;
+  stats.exportLastBin(last);
+  check(HEADER + last.text == want, "exportLastBin matches the stored bin", last.text);
+}
+
+
+// A vehicle over the detector at the boundary: counted once, time split
+static void checkOccupancySplit() {
+  eraseEeprom();
+  TrafficStats stats;
+  boot(stats, 1, 10, 0);
+  run(stats, BIN_S - 45);                  // 10:14:15
+  vehicle(stats, 0, 90);                   // 45 s in each bin (5%)
+  closeBin(stats);
+
+  std::string want = HEADER
+    "2024-03-01 10:00,1,1,5.0,0\n"
+    "2024-03-01 10:00,2,0,0.0,0\n"
+    "2024-03-01 10:15,1,0,5.0,0\n"
+    "2024-03-01 10:15,2,0,0.0,0\n";
+  std::string got = exportBins(stats);
+  check(got == want, "occupancy split across bins", got, want);
+}
+
+
+// 100 bins over midnight in a 96 slot ring: the 96 newest, oldest first.
+// Reboot keeps them, the next bin goes after the newest one.
+static void checkRingWrapAndReboot() {
+  eraseEeprom();
+  TrafficStats stats;
+  boot(stats, 1, 6, 0);
+  uint32_t start = unixNow;
+  for(int i=0; i<100; i++) closeBin(stats);
+
+  std::string want = HEADER;
+  for(int i=4; i<100; i++) want += emptyBin(start + i * BIN_S);
+  std::string got = exportBins(stats);
+  check(got == want, "ring wrap keeps the 96 newest bins", got, want);
+
+  // power-on 2 bins later: the running bin was lost, stored bins are kept
+  uint32_t rebootAt = unixNow + 2 * BIN_S;
+  TrafficStats rebooted;
+  unixNow = rebootAt;
+  rebooted.init(BIN_15_MIN, DateTime(unixNow));
+  got = exportBins(rebooted);
+  check(got == want, "reboot finds the head from the serials", got, want);
+
+  closeBin(rebooted);
+  want = HEADER;
+  for(int i=5; i<100; i++) want += emptyBin(start + i * BIN_S);
+  want += emptyBin(rebootAt);
+  got = exportBins(rebooted);
+  check(got == want, "bin after reboot follows the newest", got, want);
+}
+
+
+// Stored serials are mod STATS_SERIAL_MOD: dates stay right across the wrap
+static void checkSerialWrap() {
+  eraseEeprom();
+  TrafficStats stats;
+  uint32_t start = SECONDS_FROM_1970_TO_2000 + (STATS_SERIAL_MOD - 2) * BIN_S;
+  unixNow = start;
+  stats.init(BIN_15_MIN, DateTime(unixNow));
+  for(int i=0; i<4; i++) closeBin(stats);
+
+  std::string want = HEADER;
+  for(int i=0; i<4; i++) want += emptyBin(start + i * BIN_S);
+  std::string got = exportBins(stats);
+  check(got == want, "dates across the stored serial wrap", got, want);
+}
+
+
+// Reset while a bin is written: the cut slot is not exported
+static void checkTornWrite() {
+  eraseEeprom();
+  TrafficStats stats;
+  boot(stats, 1, 10, 0);
+  closeBin(stats);
+  run(stats, BIN_S - (unixNow % BIN_S));   // 10:30:00, the 10:15 bin is closed...
+  run(stats, 4);                           // ...and only partly written
+
+  TrafficStats rebooted;
+  unixNow += 60;
+  rebooted.init(BIN_15_MIN, DateTime(unixNow));
+  std::string want = HEADER + emptyBin(DateTime(2024, 3, 1, 10, 0).unixtime());
+  std::string got = exportBins(rebooted);
+  check(got == want, "partly written bin is skipped", got, want);
+}
+
+
+// EEPROM wear: no cell is written for every bin (like a head index would be),
+// a slot byte is written at most twice per turn of the ring (serial high byte)
+static void checkWear() {
+  eraseEeprom();
+  TrafficStats stats;
+  boot(stats, 1, 0, 0);
+  uint32_t before[EEPROM_SIZE];
+  for(int i=0; i<EEPROM_SIZE; i++) before[i] = EEPROM.hostWrites(i);
+
+  const int turns = 3;
+  for(int i=0; i<turns * STATS_EEPROM_BINS; i++) {
+    vehicle(stats, i % NUM_APPROACH, 1 + i % 7);
+    closeBin(stats);
+  }
+
+  uint32_t maxWrites = 0;
+  for(int i=0; i<EEPROM_SIZE; i++) {
+    uint32_t n = EEPROM.hostWrites(i) - before[i];
+    if(n > maxWrites) maxWrites = n;
+  }
+  check(maxWrites <= 2 * turns, "EEPROM cells written at most twice per turn");
+}
+
+
+// RTC behind the newest stored bin (set back or lost): the ring is cleared,
+// at power-on and while running
+static void checkRtcBehind() {
+  eraseEeprom();
+  TrafficStats stats;
+  boot(stats, 3, 10, 0);
+  closeBin(stats);
+  closeBin(stats);
+
+  TrafficStats rebooted;
+  boot(rebooted, 3, 10, 20);                // before the end of the 10:15 bin
+  check(exportBins(rebooted) == HEADER, "init() clears the ring when the RTC is behind", exportBins(rebooted));
+
+  closeBin(rebooted);
+  std::string want = HEADER + emptyBin(DateTime(2024, 3, 3, 10, 15).unixtime());
+  std::string got = exportBins(rebooted);
+  check(got == want, "ring restarts after the clear", got, want);
+
+  unixNow = DateTime(2024, 3, 2, 8, 0).unixtime();
+  check(!rebooted.update(DateTime(unixNow)), "update() closes no bin when the RTC goes back");
+  check(exportBins(rebooted) == HEADER, "update() clears the ring when the RTC goes back", exportBins(rebooted));
+
+  closeBin(rebooted);
+  want = HEADER + emptyBin(DateTime(2024, 3, 2, 8, 0).unixtime());
+  got = exportBins(rebooted);
+  check(got == want, "bins after the clock change are dated right", got, want);
+  check(countLines(got) == 3, "one bin stored after the clock change");
+}
+
+
+// update() called late, past a bin boundary: the old bin keeps its date and takes
+// everything counted since, the next bin is the one of the RTC (the bin in between
+// is missing, not misdated). A long stall does not overflow the occupancy.
+static void checkLateUpdate() {
+  eraseEeprom();
+  TrafficStats stats;
+  boot(stats, 1, 10, 0);
+  run(stats, 5 * 60);
+  vehicle(stats, 0, 2);
+  stall(15 * 60);                          // 10:20, update() not called
+  stats.detectorChange(1, true);
+  stall(11 * 60);                          // 10:31
+  stats.detectorChange(1, false);
+  check(run(stats, 1) == 1, "late update() closes one bin");
+  closeBin(stats);
+
+  std::string want = HEADER
+    "2024-03-01 10:00,1,1,0.0,0\n"
+    "2024-03-01 10:00,2,1,35.0,0\n"
+    + emptyBin(DateTime(2024, 3, 1, 10, 30).unixtime());
+  std::string got = exportBins(stats);
+  check(got == want, "bins stay aligned after a late update()", got, want);
+
+  // vehicle parked on the loop for 7 hours without update()
+  eraseEeprom();
+  TrafficStats parked;
+  boot(parked, 2, 10, 0);
+  run(parked, 60);
+  parked.detectorChange(0, true);
+  stall(7 * 3600 - 60);
+  run(parked, 1);
+  want = HEADER
+    "2024-03-02 10:00,1,1,99.5,0\n"
+    "2024-03-02 10:00,2,0,0.0,0\n";
+  got = exportBins(parked);
+  check(got == want, "occupancy of a 7 h bin does not overflow", got, want);
+}
+
+
+int main() {
+  checkPartialFirstBin();
+  checkOccupancySplit();
+  checkRingWrapAndReboot();
+  checkSerialWrap();
+  checkWear();
+  checkTornWrite();
+  checkRtcBehind();
+  checkLateUpdate();
+
+  printf("%s\n", failures ? "FAILED" : "all checks passed");
+  return failures ? 1 : 0;
+}